@@ -0,0 +1,152 @@
+// Unordered work distribution: ConcurrentBag against MPMCQueue.
+// "mixed": every thread adds a burst and removes a burst, so most removals
+// hit the thread's own chunk. "split": half the threads only add and half
+// only remove, so every bag removal is a steal.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "lockfree/bag.hpp"
+#include "lockfree/mpmc_queue.hpp"
+
+namespace {
+
+constexpr int BURST = 64;
+constexpr int ROUNDS = 20000;
+constexpr uint64_t SPLIT_ITEMS = 1 << 21;  // Total handed from producers to consumers
+
+unsigned thread_count() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n < 2 ? 2 : n;
+}
+
+/**
+ * @brief Start threads together and return ns per operation over all of them
+ */
+template<typename Body>
+double run_threads(unsigned threads, uint64_t ops, Body body) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            body(t);
+        });
+    }
+    auto start = bench::Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : pool) {
+        t.join();
+    }
+    return bench::ns_since(start) / ops;
+}
+
+double bag_mixed(unsigned threads) {
+    lockfree::ConcurrentBag<uint64_t> bag(threads);
+    std::vector<uint64_t> items(threads * BURST);
+    return run_threads(threads, 2ull * threads * BURST * ROUNDS, [&](unsigned t) {
+        auto handle = bag.register_thread();
+        uint64_t* mine = &items[t * BURST];
+        uint64_t sum = 0;
+        for (int r = 0; r < ROUNDS; ++r) {
+            for (int i = 0; i < BURST; ++i) {
+                handle.add(&mine[i]);
+            }
+            for (int i = 0; i < BURST; ++i) {
+                if (uint64_t* p = handle.try_remove()) {
+                    sum += *p;
+                }
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+double queue_mixed(unsigned threads) {
+    lockfree::MPMCQueue<uint64_t*> q(threads * BURST);
+    std::vector<uint64_t> items(threads * BURST);
+    return run_threads(threads, 2ull * threads * BURST * ROUNDS, [&](unsigned t) {
+        uint64_t* mine = &items[t * BURST];
+        uint64_t sum = 0;
+        for (int r = 0; r < ROUNDS; ++r) {
+            for (int i = 0; i < BURST; ++i) {
+                q.try_enqueue(&mine[i]);
+            }
+            uint64_t* p;
+            for (int i = 0; i < BURST; ++i) {
+                if (q.try_dequeue(p)) {
+                    sum += *p;
+                }
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+/**
+ * @brief Half the threads produce SPLIT_ITEMS items, the other half consume them
+ */
+template<typename Add, typename Remove>
+double split(unsigned threads, Add add, Remove remove) {
+    const unsigned producers = threads / 2;
+    const uint64_t per_producer = SPLIT_ITEMS / producers;
+    const uint64_t total = per_producer * producers;
+    std::atomic<uint64_t> consumed{0};
+    uint64_t item = 1;
+    return run_threads(threads, 2 * total, [&](unsigned t) {
+        if (t < producers) {
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                while (!add(t, &item)) {
+                    std::this_thread::yield();
+                }
+            }
+            return;
+        }
+        while (consumed.load(std::memory_order_relaxed) < total) {
+            if (remove(t)) {
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+}
+
+double bag_split(unsigned threads) {
+    lockfree::ConcurrentBag<uint64_t> bag(threads);
+    std::vector<lockfree::ConcurrentBag<uint64_t>::Handle> handles;
+    for (unsigned t = 0; t < threads; ++t) {
+        handles.push_back(bag.register_thread());
+    }
+    return split(threads,
+                 [&](unsigned t, uint64_t* p) { handles[t].add(p); return true; },
+                 [&](unsigned t) { return handles[t].try_remove() != nullptr; });
+}
+
+double queue_split(unsigned threads) {
+    lockfree::MPMCQueue<uint64_t*> q(4096);
+    return split(threads,
+                 [&](unsigned, uint64_t* p) { return q.try_enqueue(p); },
+                 [&](unsigned) {
+                     uint64_t* p;
+                     return q.try_dequeue(p);
+                 });
+}
+
+} // namespace
+
+int main() {
+    const unsigned threads = thread_count();
+    std::printf("%u threads\n", threads);
+    bench::report("ConcurrentBag mixed", bag_mixed(threads));
+    bench::report("MPMCQueue mixed", queue_mixed(threads));
+    bench::report("ConcurrentBag split", bag_split(threads));
+    bench::report("MPMCQueue split", queue_split(threads));
+    return 0;
+}
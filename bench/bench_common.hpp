@@ -0,0 +1,26 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Keep the optimizer from discarding a computed value
+ */
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline double ns_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+inline void report(const char* name, double ns_per_op) {
+    std::printf("%-40s %10.2f ns/op\n", name, ns_per_op);
+}
+
+} // namespace bench
@@ -0,0 +1,196 @@
+// Deadline-miss rate under rising load: DeadlineQueue (EDF) against a FIFO
+// MPMCQueue. Tasks are a mix of urgent and bulk work arriving at a paced
+// rate; workers spin for a fixed service time per task. A task misses when
+// it is started after its deadline (both queues drop it) or could not be
+// submitted at all.
+//
+// Two arrival sources:
+// - "shared": one producer thread submits everything (try_submit)
+// - "local": each worker generates its own share of the arrivals and
+//   pushes them to its local heap (push_local), spilling to the shared
+//   level past the spill threshold
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "lockfree/deadline_queue.hpp"
+#include "lockfree/mpmc_queue.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr int TASKS = 20000;
+constexpr int URGENT_EVERY = 5;  // One task in five is urgent
+constexpr auto SERVICE = 2us;
+constexpr auto URGENT_SLACK = 100us;
+constexpr auto BULK_SLACK = 5ms;
+
+struct Item {
+    bench::Clock::time_point deadline;
+    bool urgent;
+};
+
+struct Result {
+    double urgent_miss;
+    double bulk_miss;
+};
+
+enum class Source {
+    Shared,  // One producer thread
+    Local    // Each worker generates its own arrivals
+};
+
+unsigned worker_count() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 2 ? n - 1 : 1;
+}
+
+void serve(std::chrono::nanoseconds service) {
+    auto end = bench::Clock::now() + service;
+    while (bench::Clock::now() < end) {
+    }
+}
+
+/**
+ * @brief Paced arrivals: count tasks, one every gap
+ */
+class Arrivals {
+private:
+    bench::Clock::time_point next_;
+    bench::Clock::duration gap_;
+    int left_;
+    int seq_{0};
+
+public:
+    Arrivals(int count, bench::Clock::duration gap)
+        : next_(bench::Clock::now()), gap_(gap), left_(count) {}
+
+    bool finished() const noexcept {
+        return left_ == 0;
+    }
+
+    bool due() const noexcept {
+        return left_ > 0 && bench::Clock::now() >= next_;
+    }
+
+    Item take() {
+        next_ += gap_;
+        --left_;
+        bool urgent = seq_++ % URGENT_EVERY == 0;
+        return Item{bench::Clock::now() + (urgent ? URGENT_SLACK : BULK_SLACK), urgent};
+    }
+};
+
+/**
+ * @brief Run the arrivals and workers
+ *
+ * submit(item) is called by the producer thread, push(w, item) and
+ * pop(w, item) by worker w.
+ */
+template<typename Submit, typename Push, typename Pop>
+Result run(double load, Source source, Submit submit, Push push, Pop pop) {
+    const unsigned workers = worker_count();
+    const auto gap = std::chrono::duration_cast<bench::Clock::duration>(
+        SERVICE / (workers * load));
+
+    std::atomic<bool> done{source == Source::Local};
+    std::atomic<int> urgent_total{0};
+    std::atomic<int> urgent_ok{0};
+    std::atomic<int> bulk_ok{0};
+
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < workers; ++w) {
+        pool.emplace_back([&, w] {
+            const int share = source == Source::Local
+                ? TASKS / int(workers) + (w < TASKS % workers ? 1 : 0) : 0;
+            Arrivals arrivals(share, gap * workers);
+            Item item;
+            while (true) {
+                while (arrivals.due()) {
+                    Item next = arrivals.take();
+                    urgent_total.fetch_add(next.urgent, std::memory_order_relaxed);
+                    push(w, next);
+                }
+                if (!pop(w, item)) {
+                    if (!arrivals.finished() || !done.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    if (!pop(w, item)) {
+                        return;
+                    }
+                }
+                if (bench::Clock::now() > item.deadline) {
+                    continue;  // Late, dropped
+                }
+                serve(SERVICE);
+                (item.urgent ? urgent_ok : bulk_ok).fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    if (source == Source::Shared) {
+        Arrivals arrivals(TASKS, gap);
+        while (!arrivals.finished()) {
+            if (!arrivals.due()) {
+                std::this_thread::yield();
+                continue;
+            }
+            Item next = arrivals.take();
+            urgent_total.fetch_add(next.urgent, std::memory_order_relaxed);
+            submit(next);
+        }
+        done.store(true, std::memory_order_release);
+    }
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    const int urgent = urgent_total.load();
+    const int bulk = TASKS - urgent;
+    return Result{1.0 - double(urgent_ok.load()) / urgent,
+                  1.0 - double(bulk_ok.load()) / bulk};
+}
+
+Result run_edf(double load, Source source) {
+    lockfree::DeadlineQueue<Item, bench::Clock> q(worker_count(), 256, 4096, 40us);
+    return run(load, source,
+               [&](const Item& item) { q.try_submit(item.deadline, item); },
+               [&](unsigned w, const Item& item) { q.push_local(w, item.deadline, item); },
+               [&](unsigned w, Item& out) { return q.try_pop(w, out); });
+}
+
+Result run_fifo(double load, Source source) {
+    lockfree::MPMCQueue<Item> q(TASKS);
+    return run(load, source,
+               [&](const Item& item) { q.try_enqueue(item); },
+               [&](unsigned, const Item& item) { q.try_enqueue(item); },
+               [&](unsigned, Item& out) { return q.try_dequeue(out); });
+}
+
+void print(const char* name, const char* source, double load, const Result& r) {
+    std::printf("%-14s %-6s load %4.2f  urgent miss %6.2f%%  bulk miss %6.2f%%\n",
+                name, source, load, 100.0 * r.urgent_miss, 100.0 * r.bulk_miss);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%u workers, service %lld ns, urgent slack %lld us, bulk slack %lld us\n",
+                worker_count(), static_cast<long long>(std::chrono::nanoseconds(SERVICE).count()),
+                static_cast<long long>(URGENT_SLACK.count()),
+                static_cast<long long>(std::chrono::microseconds(BULK_SLACK).count()));
+    for (double load : {0.5, 0.9, 1.2, 2.0}) {
+        print("DeadlineQueue", "shared", load, run_edf(load, Source::Shared));
+        print("MPMCQueue", "shared", load, run_fifo(load, Source::Shared));
+        print("DeadlineQueue", "local", load, run_edf(load, Source::Local));
+        print("MPMCQueue", "local", load, run_fifo(load, Source::Local));
+    }
+    return 0;
+}
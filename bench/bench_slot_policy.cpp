@@ -0,0 +1,77 @@
+// Single-thread cost of the MPMCQueue / RingBuffer slot policies:
+// PowerOf2Mod (mask) against FastMod (exact capacity).
+
+#include <cstdint>
+
+#include "bench_common.hpp"
+#include "lockfree/mpmc_queue.hpp"
+#include "lockfree/spsc_ring_buffer.hpp"
+
+namespace {
+
+constexpr int BURST = 500;
+constexpr int ROUNDS = 20000;
+
+template<typename Queue>
+double run_mpmc(Queue& q) {
+    uint64_t sum = 0;
+    auto start = bench::Clock::now();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint64_t i = 0; i < BURST; ++i) {
+            q.try_enqueue(i);
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < BURST; ++i) {
+            q.try_dequeue(v);
+            sum += v;
+        }
+    }
+    double ns = bench::ns_since(start);
+    bench::do_not_optimize(sum);
+    return ns / (2.0 * BURST * ROUNDS);
+}
+
+template<typename Ring>
+double run_ring(Ring& ring) {
+    uint64_t sum = 0;
+    auto start = bench::Clock::now();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (uint64_t i = 0; i < BURST; ++i) {
+            ring.try_write(i);
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < BURST; ++i) {
+            ring.try_read(v);
+            sum += v;
+        }
+    }
+    double ns = bench::ns_since(start);
+    bench::do_not_optimize(sum);
+    return ns / (2.0 * BURST * ROUNDS);
+}
+
+} // namespace
+
+int main() {
+    {
+        lockfree::MPMCQueue<uint64_t> q(1024);
+        bench::report("MPMCQueue PowerOf2Mod (1024)", run_mpmc(q));
+    }
+    {
+        lockfree::ExactMPMCQueue<uint64_t> q(1024, lockfree::exact_capacity);
+        bench::report("MPMCQueue FastMod (1024)", run_mpmc(q));
+    }
+    {
+        lockfree::ExactMPMCQueue<uint64_t> q(1000, lockfree::exact_capacity);
+        bench::report("MPMCQueue FastMod (1000)", run_mpmc(q));
+    }
+    {
+        Lockfree::RingBuffer<uint64_t> ring(1024);
+        bench::report("RingBuffer PowerOf2Mod (1024)", run_ring(ring));
+    }
+    {
+        Lockfree::ExactRingBuffer<uint64_t> ring(1000, lockfree::exact_capacity);
+        bench::report("RingBuffer FastMod (1000)", run_ring(ring));
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+// Cold-start cost of large MPMCQueues: construction (allocation, page
+// faults, sequence init) with one init thread against all hardware threads.
+// Each queue is built fresh, so every run pays its own page faults.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "bench_common.hpp"
+#include "lockfree/mpmc_queue.hpp"
+
+namespace {
+
+constexpr int RUNS = 3;
+
+/**
+ * @brief Best-of-RUNS time to construct the queue and pass one item through
+ */
+double construct_ms(size_t capacity, unsigned init_threads) {
+    double best = 0;
+    for (int r = 0; r < RUNS; ++r) {
+        auto start = bench::Clock::now();
+        lockfree::MPMCQueue<uint64_t> q(capacity, init_threads);
+        q.try_enqueue(uint64_t{1});
+        uint64_t v = 0;
+        q.try_dequeue(v);
+        double ms = bench::ns_since(start) / 1e6;
+        bench::do_not_optimize(v);
+        if (r == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int shift : {20, 24, 26}) {
+        const size_t capacity = size_t{1} << shift;
+        double serial = construct_ms(capacity, 1);
+        double parallel = construct_ms(capacity, threads);
+        std::printf("MPMCQueue 2^%d  1 thread %9.2f ms  %2u threads %9.2f ms\n",
+                    shift, serial, threads, parallel);
+    }
+    return 0;
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+#include "event_count.hpp"
+
+namespace lockfree {
+
+class Mailbox;
+class Actor;
+
+/**
+ * @brief Intrusive message hook
+ *
+ * Derive messages from this. The sender owns the storage and must keep the
+ * message alive until the receiving actor's receive() returns; nothing is
+ * allocated per message.
+ */
+class Message {
+private:
+    friend class Mailbox;
+    std::atomic<Message*> next_{nullptr};
+
+public:
+    Message() noexcept = default;
+    // Copies get a fresh hook, the link is never copied
+    Message(const Message&) noexcept {}
+    Message& operator=(const Message&) noexcept { return *this; }
+};
+
+/**
+ * @brief Intrusive MPSC mailbox
+ *
+ * Based on Dmitry Vyukov's intrusive MPSC node-based queue. push() is a
+ * single exchange and is wait-free; pop() is consumer only.
+ */
+class Mailbox {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<Message*> head_;  // Producers
+    alignas(CACHE_LINE_SIZE) Message* tail_;               // Consumer
+    Message stub_;
+
+public:
+    Mailbox() noexcept : head_(&stub_), tail_(&stub_) {}
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
+    /**
+     * @brief Append a message (any thread)
+     */
+    void push(Message* msg) noexcept {
+        msg->next_.store(nullptr, std::memory_order_relaxed);
+        Message* prev = head_.exchange(msg, std::memory_order_acq_rel);
+        prev->next_.store(msg, std::memory_order_release);
+    }
+
+    /**
+     * @brief Take the oldest message (consumer only)
+     * @return nullptr if empty, or if a producer is half-way through push()
+     */
+    Message* pop() noexcept {
+        Message* tail = tail_;
+        Message* next = tail->next_.load(std::memory_order_acquire);
+
+        if (tail == &stub_) {
+            if (!next) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next_.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;  // Producer has swapped head but not linked yet
+        }
+
+        // tail is the last message, put the stub behind it so it can leave
+        push(&stub_);
+        next = tail->next_.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Fixed pool of worker threads running actors
+ *
+ * Actors sit on the run queue (an MPMCQueue) at most once, so its capacity
+ * must be at least the number of actors that can be runnable at once.
+ * Idle workers park on an EventCount.
+ */
+class Scheduler {
+private:
+    MPMCQueue<Actor*> run_queue_;
+    EventCount idle_;
+    std::atomic<bool> stopping_{false};
+    const size_t batch_;
+    std::vector<std::thread> workers_;
+
+    void worker_loop();
+
+public:
+    /**
+     * @brief Start the worker pool
+     * @param threads Number of worker threads
+     * @param run_queue_capacity Max number of runnable actors
+     * @param batch Max messages processed per activation before yielding
+     */
+    Scheduler(size_t threads, size_t run_queue_capacity, size_t batch = 64)
+        : run_queue_(run_queue_capacity)
+        , batch_(batch)
+    {
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~Scheduler() {
+        stop();
+    }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    /**
+     * @brief Put an actor on the run queue
+     */
+    void schedule(Actor* actor) {
+        while (!run_queue_.try_enqueue(actor)) {
+            std::this_thread::yield();  // Run queue undersized, wait for a slot
+        }
+        idle_.notify_one();
+    }
+
+    /**
+     * @brief Stop and join the workers. Actors still runnable are not run.
+     */
+    void stop() {
+        stopping_.store(true, std::memory_order_release);
+        idle_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers_.clear();
+    }
+};
+
+/**
+ * @brief Actor base class
+ *
+ * Messages go to an intrusive mailbox. The actor is scheduled only on the
+ * empty -> non-empty transition of its pending count, and each activation
+ * handles up to the scheduler's batch size before giving the worker up.
+ * receive() is never run concurrently for the same actor.
+ */
+class Actor {
+private:
+    friend class Scheduler;
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    Scheduler& scheduler_;
+    Mailbox mailbox_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> pending_{0};
+
+    /**
+     * @brief Process one batch
+     * @return true if messages remain and the actor must be rescheduled
+     */
+    bool run(size_t batch) {
+        size_t processed = 0;
+        while (processed < batch) {
+            Message* msg = mailbox_.pop();
+            if (!msg) {
+                break;
+            }
+            receive(*msg);
+            ++processed;
+        }
+        return pending_.fetch_sub(processed, std::memory_order_acq_rel) != processed;
+    }
+
+protected:
+    /**
+     * @brief Handle one message, msg may be reused once this returns
+     */
+    virtual void receive(Message& msg) = 0;
+
+public:
+    explicit Actor(Scheduler& scheduler) : scheduler_(scheduler) {}
+    virtual ~Actor() = default;
+
+    Actor(const Actor&) = delete;
+    Actor& operator=(const Actor&) = delete;
+
+    /**
+     * @brief Send a message to this actor (any thread)
+     */
+    void tell(Message& msg) {
+        // Count before linking so the count never drops below the messages
+        // the consumer can see
+        bool was_idle = pending_.fetch_add(1, std::memory_order_acq_rel) == 0;
+        mailbox_.push(&msg);
+        if (was_idle) {
+            scheduler_.schedule(this);
+        }
+    }
+};
+
+inline void Scheduler::worker_loop() {
+    Actor* actor;
+    while (true) {
+        if (run_queue_.try_dequeue(actor)) {
+            if (actor->run(batch_)) {
+                schedule(actor);
+            }
+            continue;
+        }
+
+        if (stopping_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        uint32_t key = idle_.prepare_wait();
+        if (!run_queue_.empty() || stopping_.load(std::memory_order_acquire)) {
+            idle_.cancel_wait();
+            continue;
+        }
+        idle_.wait(key);
+    }
+}
+
+} // namespace lockfree
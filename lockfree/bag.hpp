@@ -0,0 +1,272 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+
+namespace lockfree {
+
+/**
+ * @brief Lock-free unordered bag of pointers (after Sundell et al.)
+ *
+ * Each registered thread owns a list of chunks. add() and the local side
+ * of try_remove() work LIFO on the owner's current chunk, with no shared
+ * writes beyond the slot itself. Only when its own list is empty does a
+ * thread steal, scanning other threads' chunks and claiming a slot by CAS;
+ * it resumes after the slot it last stole, so repeated steals walk a
+ * victim's chunks once rather than rescanning them per item.
+ *
+ * The bag wins clearly when most removals are local (threads mostly
+ * consume what they produce). When producers and consumers are disjoint
+ * every removal is a steal, one CAS like an MPMCQueue dequeue, and the two
+ * are roughly on par (see bench/bench_bag.cpp).
+ *
+ * No ordering is kept. Chunks are reused by their owner and freed only when
+ * the bag is destroyed, so stealers never touch freed memory. Emptiness is
+ * approximate: try_remove() may miss an item added concurrently.
+ *
+ * The bag stores non-null T* and does not own the pointees.
+ */
+template<typename T, size_t ChunkSize = 64>
+class ConcurrentBag {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Chunk {
+        std::atomic<T*> slots[ChunkSize];
+        std::atomic<Chunk*> next{nullptr};  // Older chunk, read by stealers
+        Chunk* newer{nullptr};              // Owner only, kept for reuse
+
+        Chunk() {
+            for (auto& slot : slots) {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ThreadList {
+        std::atomic<Chunk*> head{nullptr};  // Newest chunk, for stealers
+
+        // Owner only
+        Chunk* current{nullptr};
+        size_t index{0};        // Next free slot in current
+        size_t last_victim{0};  // Where the last steal succeeded
+        Chunk* last_chunk{nullptr};  // Chunk of last_victim it succeeded in
+        size_t last_slot{0};         // Slot in last_chunk after the stolen one
+    };
+
+    std::unique_ptr<ThreadList[]> lists_;
+    const size_t max_threads_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> registered_{0};
+
+    static bool drained(const Chunk& chunk) noexcept {
+        for (const auto& slot : chunk.slots) {
+            if (slot.load(std::memory_order_relaxed)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Claim the first item from slot first of chunk onwards
+     *
+     * On success found and next_slot say where to resume, so a thread that
+     * keeps stealing from the same victim walks each chunk once instead of
+     * rescanning it for every item.
+     */
+    static T* claim_from(Chunk* chunk, size_t first, Chunk*& found, size_t& next_slot) {
+        for (; chunk; chunk = chunk->next.load(std::memory_order_acquire), first = 0) {
+            for (size_t i = first; i < ChunkSize; ++i) {
+                std::atomic<T*>& slot = chunk->slots[i];
+                T* item = slot.load(std::memory_order_relaxed);
+                if (item && slot.compare_exchange_strong(item, nullptr,
+                                                         std::memory_order_acquire,
+                                                         std::memory_order_relaxed)) {
+                    found = chunk;
+                    next_slot = i + 1;
+                    return item;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void add(size_t id, T* item) {
+        ThreadList& list = lists_[id];
+
+        if (list.current && list.index == ChunkSize && drained(*list.current)) {
+            // Stealers emptied it; refill in place so a thread that only adds
+            // does not grow its list while others keep up
+            list.index = 0;
+        } else if (!list.current || list.index == ChunkSize) {
+            Chunk* chunk = list.current ? list.current->newer : nullptr;
+            if (!chunk) {
+                chunk = new Chunk();
+                chunk->next.store(list.current, std::memory_order_relaxed);
+                if (list.current) {
+                    list.current->newer = chunk;
+                }
+                list.head.store(chunk, std::memory_order_release);
+            }
+            list.current = chunk;
+            list.index = 0;
+        }
+
+        list.current->slots[list.index++].store(item, std::memory_order_release);
+    }
+
+    T* try_remove(size_t id) {
+        ThreadList& list = lists_[id];
+
+        while (list.current) {
+            if (list.index == 0) {
+                Chunk* older = list.current->next.load(std::memory_order_relaxed);
+                if (!older) {
+                    break;  // Local list is empty
+                }
+                list.current = older;
+                list.index = ChunkSize;
+                continue;
+            }
+
+            std::atomic<T*>& slot = list.current->slots[--list.index];
+            // Exchange, not store: a stealer may be claiming the same slot
+            if (slot.load(std::memory_order_relaxed)) {
+                if (T* item = slot.exchange(nullptr, std::memory_order_acquire)) {
+                    return item;
+                }
+            }
+        }
+
+        return steal(id);
+    }
+
+    T* steal(size_t id) {
+        ThreadList& self = lists_[id];
+        const size_t n = registered_.load(std::memory_order_acquire);
+
+        for (size_t k = 0; k < n; ++k) {
+            const size_t victim = (self.last_victim + k) % n;
+            if (victim == id) {
+                continue;
+            }
+
+            // Resume right after the last stolen slot of this victim: what
+            // it passed was empty then. Chunks are never freed while the bag
+            // lives, so the cached pointer stays valid.
+            Chunk* found = nullptr;
+            size_t next_slot = 0;
+            T* item = nullptr;
+            if (k == 0 && self.last_chunk) {
+                item = claim_from(self.last_chunk, self.last_slot, found, next_slot);
+            }
+            if (!item) {
+                item = claim_from(lists_[victim].head.load(std::memory_order_acquire), 0,
+                                  found, next_slot);
+            }
+            if (item) {
+                self.last_victim = victim;
+                self.last_chunk = found;
+                self.last_slot = next_slot;
+                return item;
+            }
+        }
+
+        return nullptr;
+    }
+
+public:
+    /**
+     * @brief Per-thread access to the bag
+     *
+     * Obtain one per thread with register_thread(); a Handle must only be
+     * used by one thread at a time.
+     */
+    class Handle {
+    private:
+        friend class ConcurrentBag;
+
+        ConcurrentBag* bag_;
+        size_t id_;
+
+        Handle(ConcurrentBag* bag, size_t id) : bag_(bag), id_(id) {}
+
+    public:
+        /**
+         * @brief Add an item to this thread's chunk list
+         */
+        void add(T* item) {
+            bag_->add(id_, item);
+        }
+
+        /**
+         * @brief Remove some item, local first, then stolen
+         * @return the item, or nullptr if the bag looked empty
+         */
+        T* try_remove() {
+            return bag_->try_remove(id_);
+        }
+    };
+
+    /**
+     * @brief Construct bag
+     * @param max_threads Maximum number of threads that will register
+     */
+    explicit ConcurrentBag(size_t max_threads)
+        : lists_(new ThreadList[max_threads])
+        , max_threads_(max_threads)
+    {}
+
+    ~ConcurrentBag() {
+        const size_t n = registered_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            Chunk* chunk = lists_[i].head.load(std::memory_order_relaxed);
+            while (chunk) {
+                Chunk* older = chunk->next.load(std::memory_order_relaxed);
+                delete chunk;
+                chunk = older;
+            }
+        }
+    }
+
+    // Non-copyable, non-movable
+    ConcurrentBag(const ConcurrentBag&) = delete;
+    ConcurrentBag& operator=(const ConcurrentBag&) = delete;
+    ConcurrentBag(ConcurrentBag&&) = delete;
+    ConcurrentBag& operator=(ConcurrentBag&&) = delete;
+
+    /**
+     * @brief Register the calling thread
+     * @throws std::runtime_error if max_threads handles were already handed out
+     */
+    Handle register_thread() {
+        size_t id = registered_.fetch_add(1, std::memory_order_acq_rel);
+        if (id >= max_threads_) {
+            registered_.fetch_sub(1, std::memory_order_acq_rel);
+            throw std::runtime_error("ConcurrentBag: too many threads");
+        }
+        return Handle(this, id);
+    }
+
+    /**
+     * @brief Check if bag is empty (approximate, scans every chunk)
+     */
+    bool empty() const noexcept {
+        const size_t n = registered_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+            Chunk* chunk = lists_[i].head.load(std::memory_order_acquire);
+            for (; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+                for (const auto& slot : chunk->slots) {
+                    if (slot.load(std::memory_order_relaxed)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <new>
+
+#if defined(__x86_64__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace lockfree {
+
+/**
+ * @brief Cache-line-batched SPSC ring buffer for tiny elements
+ *
+ * For 1-8 byte trivially copyable elements. The producer fills a whole
+ * cache line in a private staging line and publishes it as a unit, the
+ * consumer releases slots a line at a time, so positions and data cross
+ * cores once per line instead of once per element.
+ *
+ * Items are invisible to the consumer until their line fills or the
+ * producer calls flush() / flush_if_older_than().
+ *
+ * Streaming = true writes full lines with non-temporal stores, which keeps
+ * very large rings from evicting the producer's working set.
+ */
+template<typename T, bool Streaming = false>
+class BatchedRingBuffer {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t PER_LINE = CACHE_LINE_SIZE / sizeof(T);
+    static constexpr size_t LINE_MASK = PER_LINE - 1;
+
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "BatchedRingBuffer requires trivially copyable T");
+    static_assert(sizeof(T) <= 8 && CACHE_LINE_SIZE % sizeof(T) == 0,
+                  "BatchedRingBuffer is meant for elements of 1, 2, 4 or 8 bytes");
+
+    using Clock = std::chrono::steady_clock;
+
+    static size_t next_power_of_2(size_t n) {
+        if (n == 0) return 1;
+        --n;
+        n |= n >> 1;
+        n |= n >> 2;
+        n |= n >> 4;
+        n |= n >> 8;
+        n |= n >> 16;
+        n |= n >> 32;
+        return n + 1;
+    }
+
+    T* storage_;
+    const size_t capacity_;
+    const size_t mask_;
+
+    // Published positions, each written once per line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> write_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> read_pos_{0};
+
+    // Producer private
+    alignas(CACHE_LINE_SIZE) size_t write_{0};
+    size_t published_{0};
+    size_t cached_read_pos_{0};
+    Clock::time_point batch_start_{};
+    alignas(CACHE_LINE_SIZE) T stage_[PER_LINE];
+
+    // Consumer private
+    alignas(CACHE_LINE_SIZE) size_t read_{0};
+    size_t cached_write_pos_{0};
+    char padding_[CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+
+    /**
+     * @brief Copy staged entries [published_, write_) to the ring and publish
+     */
+    void commit() noexcept {
+        const size_t line_start = (write_ - 1) & ~LINE_MASK;
+        const size_t from = published_ > line_start ? published_ - line_start : 0;
+        const size_t to = write_ - line_start;
+        T* line = storage_ + (line_start & mask_);
+
+        if constexpr (Streaming) {
+            if (from == 0 && to == PER_LINE) {
+                stream_line(line);
+                write_pos_.store(write_, std::memory_order_release);
+                published_ = write_;
+                return;
+            }
+        }
+
+        std::memcpy(static_cast<void*>(line + from), stage_ + from, (to - from) * sizeof(T));
+        write_pos_.store(write_, std::memory_order_release);
+        published_ = write_;
+    }
+
+    void stream_line(T* line) noexcept {
+#if defined(__x86_64__) || defined(__SSE2__)
+        auto* dst = reinterpret_cast<__m128i*>(line);
+        auto* src = reinterpret_cast<const __m128i*>(stage_);
+        for (size_t i = 0; i < CACHE_LINE_SIZE / sizeof(__m128i); ++i) {
+            _mm_stream_si128(dst + i, _mm_load_si128(src + i));
+        }
+        // Non-temporal stores are weakly ordered, fence before publishing
+        _mm_sfence();
+#else
+        std::memcpy(static_cast<void*>(line), stage_, CACHE_LINE_SIZE);
+#endif
+    }
+
+public:
+    /**
+     * @brief Construct ring buffer with given capacity
+     * @param capacity Desired capacity (rounded up to a power of 2, at least two lines)
+     */
+    explicit BatchedRingBuffer(size_t capacity)
+        : capacity_(next_power_of_2(capacity < 2 * PER_LINE ? 2 * PER_LINE : capacity))
+        , mask_(capacity_ - 1)
+    {
+        storage_ = static_cast<T*>(
+            ::operator new(sizeof(T) * capacity_, std::align_val_t{CACHE_LINE_SIZE}));
+    }
+
+    ~BatchedRingBuffer() noexcept {
+        ::operator delete(storage_, std::align_val_t{CACHE_LINE_SIZE});
+    }
+
+    // Non-copyable, non-movable
+    BatchedRingBuffer(const BatchedRingBuffer&) = delete;
+    BatchedRingBuffer& operator=(const BatchedRingBuffer&) = delete;
+    BatchedRingBuffer(BatchedRingBuffer&&) = delete;
+    BatchedRingBuffer& operator=(BatchedRingBuffer&&) = delete;
+
+    /**
+     * @brief Try to write an item (producer only)
+     * @return true if successful, false if buffer is full
+     */
+    bool try_write(const T& item) noexcept {
+        if (write_ - cached_read_pos_ >= capacity_) {
+            cached_read_pos_ = read_pos_.load(std::memory_order_acquire);
+            if (write_ - cached_read_pos_ >= capacity_) {
+                return false;
+            }
+        }
+
+        if (write_ == published_) {
+            batch_start_ = Clock::now();  // Once per batch, for flush_if_older_than
+        }
+
+        stage_[write_ & LINE_MASK] = item;
+        ++write_;
+        if ((write_ & LINE_MASK) == 0) {
+            commit();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Publish a partially filled line (producer only)
+     */
+    void flush() noexcept {
+        if (write_ != published_) {
+            commit();
+        }
+    }
+
+    /**
+     * @brief Flush if the oldest unpublished item is older than max_age (producer only)
+     */
+    template<typename Rep, typename Period>
+    void flush_if_older_than(const std::chrono::duration<Rep, Period>& max_age) noexcept {
+        if (write_ != published_ && Clock::now() - batch_start_ >= max_age) {
+            commit();
+        }
+    }
+
+    /**
+     * @brief Try to read an item (consumer only)
+     * @return true if successful, false if empty
+     */
+    bool try_read(T& out) noexcept {
+        if (read_ == cached_write_pos_) {
+            // Out of data: release what we consumed so the producer can reuse it
+            if (read_pos_.load(std::memory_order_relaxed) != read_) {
+                read_pos_.store(read_, std::memory_order_release);
+            }
+            cached_write_pos_ = write_pos_.load(std::memory_order_acquire);
+            if (read_ == cached_write_pos_) {
+                return false;
+            }
+        }
+
+        out = storage_[read_ & mask_];
+        ++read_;
+        if ((read_ & LINE_MASK) == 0) {
+            read_pos_.store(read_, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Read up to max_count items (consumer only)
+     * @return number of items read
+     */
+    size_t read_bulk(T* out, size_t max_count) noexcept {
+        size_t n = 0;
+        while (n < max_count && try_read(out[n])) {
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Get approximate number of published, unconsumed items
+     */
+    size_t size() const noexcept {
+        size_t write = write_pos_.load(std::memory_order_acquire);
+        size_t read = read_pos_.load(std::memory_order_acquire);
+        // read_pos_ may have passed the write_pos_ we loaded; that reads as empty
+        return read <= write ? write - read : 0;
+    }
+
+    /**
+     * @brief Get the capacity
+     */
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+
+#include "mpmc_queue.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief Concurrent monotone bucket priority queue
+ *
+ * For keys (e.g. timestamps) that are popped in nearly increasing order.
+ * Keys are grouped into time slices of slice_width, each slice is a bucket
+ * backed by an MPMCQueue, and buckets form a circular array indexed by an
+ * atomic cursor. Items within a bucket come out in FIFO order.
+ *
+ * - Keys behind the cursor are clamped into the current bucket.
+ * - Keys more than num_buckets - 2 slices ahead are rejected.
+ * - The cursor only advances when a later bucket holds work, so an idle
+ *   queue does not run ahead of time. When an empty queue sees a key past
+ *   the horizon, the cursor jumps straight to that key's slice.
+ *
+ * An insert racing with a cursor advance can land in the previous bucket;
+ * pops drain that bucket first and the cursor does not move again until it
+ * is empty, so stragglers are never overtaken by more than one slice.
+ */
+template<typename T>
+class MonotoneBucketQueue {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr uint64_t JUMPING = uint64_t{1} << 63;  // Cursor flag during a jump
+
+    struct alignas(CACHE_LINE_SIZE) Bucket {
+        std::atomic<uint32_t> writers{0};  // Inserts in flight
+        MPMCQueue<T> ring;
+
+        // MPMCQueue needs at least 2 slots to tell full from free
+        explicit Bucket(size_t capacity) : ring(std::max<size_t>(capacity, 2)) {}
+    };
+
+    static size_t next_power_of_2(size_t n) {
+        if (n == 0) return 1;
+        --n;
+        n |= n >> 1;
+        n |= n >> 2;
+        n |= n >> 4;
+        n |= n >> 8;
+        n |= n >> 16;
+        n |= n >> 32;
+        return n + 1;
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> cursor_;  // Absolute bucket index
+    alignas(CACHE_LINE_SIZE) const uint64_t slice_width_;
+    const size_t num_buckets_;
+    const size_t mask_;
+    std::vector<std::unique_ptr<Bucket>> buckets_;
+
+    Bucket& bucket(uint64_t index) noexcept {
+        return *buckets_[index & mask_];
+    }
+
+    const Bucket& bucket(uint64_t index) const noexcept {
+        return *buckets_[index & mask_];
+    }
+
+    /**
+     * @brief Try to move the cursor past the (empty) current bucket
+     */
+    void try_advance(uint64_t cur) {
+        // Only advance if some later bucket has work
+        bool ahead = false;
+        for (size_t k = 1; k + 1 < num_buckets_; ++k) {
+            if (!bucket(cur + k).ring.empty()) {
+                ahead = true;
+                break;
+            }
+        }
+        if (!ahead) {
+            return;
+        }
+
+        // The previous bucket becomes a legal target again after we move,
+        // so it must have no stragglers left or arriving
+        Bucket& prev = bucket(cur - 1);
+        if (prev.writers.load(std::memory_order_seq_cst) != 0 || !prev.ring.empty()) {
+            return;
+        }
+        Bucket& current = bucket(cur);
+        if (current.writers.load(std::memory_order_seq_cst) != 0 || !current.ring.empty()) {
+            return;
+        }
+
+        cursor_.compare_exchange_strong(cur, cur + 1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Move the cursor of an empty queue straight to target
+     *
+     * Inserts are held off by the JUMPING flag while we wait for in-flight
+     * ones; if any of them landed, the jump is abandoned.
+     */
+    bool try_jump(uint64_t cur, uint64_t target) {
+        if (!empty()) {
+            return false;
+        }
+        if (!cursor_.compare_exchange_strong(cur, cur | JUMPING, std::memory_order_seq_cst)) {
+            return false;
+        }
+        for (const auto& b : buckets_) {
+            while (b->writers.load(std::memory_order_seq_cst) != 0) {
+                std::this_thread::yield();
+            }
+        }
+        bool clean = empty();
+        cursor_.store(clean ? target : cur, std::memory_order_seq_cst);
+        return clean;
+    }
+
+public:
+    /**
+     * @brief Construct queue
+     * @param num_buckets Number of time slices (rounded up to power of 2, at least 4)
+     * @param bucket_capacity Capacity of each bucket ring
+     * @param slice_width Key range covered by one bucket
+     * @param start_key Smallest key expected
+     */
+    MonotoneBucketQueue(size_t num_buckets, size_t bucket_capacity,
+                        uint64_t slice_width, uint64_t start_key = 0)
+        : cursor_(start_key / std::max<uint64_t>(slice_width, 1))
+        , slice_width_(std::max<uint64_t>(slice_width, 1))
+        , num_buckets_(next_power_of_2(std::max<size_t>(num_buckets, 4)))
+        , mask_(num_buckets_ - 1)
+    {
+        buckets_.reserve(num_buckets_);
+        for (size_t i = 0; i < num_buckets_; ++i) {
+            buckets_.push_back(std::make_unique<Bucket>(bucket_capacity));
+        }
+    }
+
+    // Non-copyable, non-movable
+    MonotoneBucketQueue(const MonotoneBucketQueue&) = delete;
+    MonotoneBucketQueue& operator=(const MonotoneBucketQueue&) = delete;
+    MonotoneBucketQueue(MonotoneBucketQueue&&) = delete;
+    MonotoneBucketQueue& operator=(MonotoneBucketQueue&&) = delete;
+
+    /**
+     * @brief Insert an item with the given key (any thread)
+     * @return false if the bucket is full or the key is beyond the horizon;
+     *         item is only moved from on success
+     */
+    template<typename U>
+    bool try_push(uint64_t key, U&& item) {
+        return try_emplace(key, std::forward<U>(item));
+    }
+
+    /**
+     * @brief Construct an item in place with the given key (any thread)
+     * @return false if the bucket is full or the key is beyond the horizon;
+     *         args are only used on success
+     */
+    template<typename... Args>
+    bool try_emplace(uint64_t key, Args&&... args) {
+        const uint64_t wanted = key / slice_width_;
+
+        while (true) {
+            uint64_t cur = cursor_.load(std::memory_order_acquire);
+            if (cur & JUMPING) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint64_t index = std::max(wanted, cur);
+            if (index - cur > num_buckets_ - 2) {
+                // Beyond the horizon, unless the queue is idle and can jump
+                if (!try_jump(cur, wanted)) {
+                    return false;
+                }
+                continue;
+            }
+
+            Bucket& b = bucket(index);
+            b.writers.fetch_add(1, std::memory_order_seq_cst);
+            if (cursor_.load(std::memory_order_seq_cst) != cur) {
+                // Cursor moved (or is jumping), re-clamp
+                b.writers.fetch_sub(1, std::memory_order_release);
+                continue;
+            }
+
+            bool ok = b.ring.try_emplace(std::forward<Args>(args)...);
+            b.writers.fetch_sub(1, std::memory_order_release);
+            return ok;
+        }
+    }
+
+    /**
+     * @brief Pop an item from the earliest non-empty bucket (any thread)
+     * @return std::optional containing the item if successful, std::nullopt if empty
+     */
+    std::optional<T> try_pop() {
+        while (true) {
+            uint64_t cur = cursor_.load(std::memory_order_acquire);
+            if (cur & JUMPING) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Stragglers from the previous slice go first
+            if (auto item = bucket(cur - 1).ring.try_dequeue()) {
+                return item;
+            }
+            if (auto item = bucket(cur).ring.try_dequeue()) {
+                return item;
+            }
+
+            try_advance(cur);
+            if (cursor_.load(std::memory_order_acquire) == cur) {
+                // Could not advance: nothing ahead, or stragglers to drain
+                if (bucket(cur - 1).ring.empty() && bucket(cur).ring.empty()) {
+                    return std::nullopt;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Pop into existing object
+     * @return true if successful, false if empty
+     */
+    bool try_pop(T& out) {
+        auto item = try_pop();
+        if (!item) {
+            return false;
+        }
+        out = std::move(*item);
+        return true;
+    }
+
+    /**
+     * @brief Absolute index of the current bucket
+     */
+    uint64_t cursor() const noexcept {
+        return cursor_.load(std::memory_order_acquire) & ~JUMPING;
+    }
+
+    /**
+     * @brief Smallest key of the current bucket, lower bound for the next pop
+     */
+    uint64_t current_key() const noexcept {
+        return cursor() * slice_width_;
+    }
+
+    /**
+     * @brief Smallest key of the earliest non-empty bucket (approximate)
+     *
+     * Stragglers in the previous bucket count as the current one, as they
+     * are popped first.
+     * @return std::nullopt if every bucket looked empty
+     */
+    std::optional<uint64_t> front_key() const noexcept {
+        const uint64_t cur = cursor();
+        if (!bucket(cur - 1).ring.empty() || !bucket(cur).ring.empty()) {
+            return cur * slice_width_;
+        }
+        for (size_t k = 1; k + 1 < num_buckets_; ++k) {
+            if (!bucket(cur + k).ring.empty()) {
+                return (cur + k) * slice_width_;
+            }
+        }
+        return std::nullopt;
+    }
+
+    uint64_t slice_width() const noexcept {
+        return slice_width_;
+    }
+
+    size_t num_buckets() const noexcept {
+        return num_buckets_;
+    }
+
+    /**
+     * @brief Check if queue is empty (approximate)
+     */
+    bool empty() const noexcept {
+        for (const auto& b : buckets_) {
+            if (!b->ring.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get approximate size
+     */
+    size_t size() const noexcept {
+        size_t total = 0;
+        for (const auto& b : buckets_) {
+            total += b->ring.size();
+        }
+        return total;
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,573 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <new>
+#include <algorithm>
+
+#include "mpmc_queue.hpp"
+#include "event_count.hpp"
+
+namespace lockfree {
+
+template<typename T> class RecvCase;
+template<typename T> class SendCase;
+
+/**
+ * @brief Go-style typed channel
+ *
+ * capacity > 0: buffered channel backed by MPMCQueue (capacity rounded up
+ * to a power of 2, at least 2). capacity == 0: unbuffered rendezvous channel, send
+ * returns only once a receiver has taken the value; try_send only hands a
+ * value to a receiver that is already parked, and never waits for it.
+ *
+ * Try operations are lock-free. Blocking operations park on an EventCount
+ * (futex) and notifiers only pay for a wakeup when someone is parked.
+ * close() wakes every waiter; receivers still drain buffered items.
+ */
+template<typename T>
+class Channel {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    friend class RecvCase<T>;
+    friend class SendCase<T>;
+
+    // Buffered mode, null for rendezvous channels
+    std::unique_ptr<MPMCQueue<T>> queue_;
+
+    // Rendezvous mode: a single hand-off slot. Sender with ticket t owns the
+    // slot once done_ == t, publishes it, and receivers claim it by CAS.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> turn_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> claimed_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> done_{0};
+    std::atomic<std::thread::id> publisher_{};  // A thread never receives its own value
+    alignas(T) std::byte slot_[sizeof(T)];
+
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> closed_{false};
+
+    EventCount readable_;  // Receivers park here
+    EventCount writable_;  // Senders park here
+
+    struct Watcher {
+        EventCount* ev;
+        bool receiver;  // Watching for a receive case
+    };
+
+    // Select waiters watching this channel (slow path only)
+    std::atomic<uint32_t> watcher_count_{0};
+    std::atomic<uint32_t> recv_watchers_{0};  // Selects with a receive case on us
+    std::mutex watchers_mtx_;
+    std::vector<Watcher> watchers_;
+
+    T* slot_ptr() noexcept {
+        return reinterpret_cast<T*>(slot_);
+    }
+
+    void notify_watchers() {
+        // Callers just ran a seq_cst fence inside EventCount::notify_*
+        if (watcher_count_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        std::lock_guard lock(watchers_mtx_);
+        for (const Watcher& w : watchers_) {
+            w.ev->notify_all();
+        }
+    }
+
+    void signal_readable() {
+        readable_.notify_one();
+        notify_watchers();
+    }
+
+    void signal_writable() {
+        if (queue_) {
+            writable_.notify_one();
+        } else {
+            // Senders wait on distinct tickets, wake them all
+            writable_.notify_all();
+        }
+        notify_watchers();
+    }
+
+    void add_watcher(EventCount* ev, bool receiver) {
+        std::lock_guard lock(watchers_mtx_);
+        watchers_.push_back(Watcher{ev, receiver});
+        if (receiver) {
+            recv_watchers_.fetch_add(1, std::memory_order_relaxed);
+        }
+        watcher_count_.fetch_add(1, std::memory_order_seq_cst);
+        if (receiver && !queue_) {
+            // As in recv(): selects parked on sending to us can go ahead
+            for (const Watcher& other : watchers_) {
+                if (other.ev != ev) {
+                    other.ev->notify_all();
+                }
+            }
+        }
+    }
+
+    void remove_watcher(EventCount* ev, bool receiver) {
+        std::lock_guard lock(watchers_mtx_);
+        auto it = std::find_if(watchers_.begin(), watchers_.end(), [&](const Watcher& w) {
+            return w.ev == ev && w.receiver == receiver;
+        });
+        if (it != watchers_.end()) {
+            watchers_.erase(it);
+            if (receiver) {
+                recv_watchers_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            watcher_count_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Rendezvous: is a receiver parked in recv() or in a select?
+     *
+     * Send-side watchers do not count, and neither does self: a select with
+     * both a send and a receive case on this channel must not hand the
+     * value to itself.
+     */
+    bool receiver_parked(const EventCount* self) {
+        if (readable_.has_waiters()) {
+            return true;
+        }
+        if (recv_watchers_.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+        if (!self) {
+            return true;
+        }
+        std::lock_guard lock(watchers_mtx_);
+        return std::any_of(watchers_.begin(), watchers_.end(), [self](const Watcher& w) {
+            return w.receiver && w.ev != self;
+        });
+    }
+
+    /**
+     * @brief Rendezvous: publish the value in the slot we own
+     */
+    template<typename U>
+    void publish(uint64_t ticket, U&& item) {
+        new (slot_ptr()) T(std::forward<U>(item));
+        publisher_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        published_.store(ticket + 1, std::memory_order_release);
+        signal_readable();
+    }
+
+    /**
+     * @brief Rendezvous: claim and move out the published value, if any
+     *
+     * Skips a value this thread published itself (left by try_send for
+     * another receiver).
+     */
+    std::optional<T> take_slot() {
+        uint64_t claim = claimed_.load(std::memory_order_relaxed);
+        while (published_.load(std::memory_order_acquire) > claim) {
+            if (publisher_.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+                return std::nullopt;
+            }
+            if (claimed_.compare_exchange_weak(claim, claim + 1,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+                std::optional<T> result(std::move(*slot_ptr()));
+                slot_ptr()->~T();
+                done_.store(claim + 1, std::memory_order_release);
+                signal_writable();
+                return result;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Rendezvous: park on writable_ until done_ reaches target or close
+     */
+    bool wait_done(uint64_t target) {
+        while (done_.load(std::memory_order_acquire) < target) {
+            if (closed_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            uint32_t key = writable_.prepare_wait();
+            if (done_.load(std::memory_order_acquire) >= target ||
+                closed_.load(std::memory_order_acquire)) {
+                writable_.cancel_wait();
+                continue;
+            }
+            writable_.wait(key);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Rendezvous: hand the value over once the slot is ours (ticket t)
+     */
+    template<typename U>
+    bool handoff(uint64_t ticket, U&& item) {
+        publish(ticket, std::forward<U>(item));
+
+        if (wait_done(ticket + 1)) {
+            return true;
+        }
+
+        // Closed before a receiver showed up: withdraw unless already claimed
+        uint64_t expected = ticket;
+        if (claimed_.compare_exchange_strong(expected, ticket + 1,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+            slot_ptr()->~T();
+            done_.store(ticket + 1, std::memory_order_release);
+            signal_writable();
+            return false;
+        }
+
+        // A receiver is already moving the value out
+        while (done_.load(std::memory_order_acquire) < ticket + 1) {
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+public:
+    /**
+     * @brief Construct channel
+     * @param capacity Buffer size (rounded up to power of 2), 0 for rendezvous
+     */
+    explicit Channel(size_t capacity = 0) {
+        if (capacity > 0) {
+            // Vyukov's sequence scheme cannot tell full from free with one slot
+            queue_ = std::make_unique<MPMCQueue<T>>(std::max<size_t>(capacity, 2));
+        }
+    }
+
+    ~Channel() noexcept {
+        if (!queue_) {
+            uint64_t claim = claimed_.load(std::memory_order_relaxed);
+            if (published_.load(std::memory_order_relaxed) > claim) {
+                slot_ptr()->~T();
+            }
+        }
+    }
+
+    // Non-copyable, non-movable
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+    Channel(Channel&&) = delete;
+    Channel& operator=(Channel&&) = delete;
+
+    /**
+     * @brief Send without blocking
+     * @return true if sent. Buffered: false if full or closed. Rendezvous:
+     *         false unless a receiver (recv() or a select receive case) is
+     *         already parked and no other send is in flight; the value is
+     *         then left in the hand-off slot for it without waiting. If
+     *         that receiver was a select that fired another case, the next
+     *         receiver gets the value.
+     */
+    template<typename U>
+    bool try_send(U&& item) {
+        return try_send_from(nullptr, std::forward<U>(item));
+    }
+
+private:
+    /**
+     * @brief try_send on behalf of a select parked on self (nullptr if none)
+     */
+    template<typename U>
+    bool try_send_from(const EventCount* self, U&& item) {
+        if (closed_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        if (queue_) {
+            if (!queue_->try_enqueue(std::forward<U>(item))) {
+                return false;
+            }
+            signal_readable();
+            return true;
+        }
+
+        if (!receiver_parked(self)) {
+            return false;
+        }
+        // Only take a ticket if no other sender is in flight, so the slot is ours
+        uint64_t ticket = done_.load(std::memory_order_acquire);
+        uint64_t expected = ticket;
+        if (!turn_.compare_exchange_strong(expected, ticket + 1,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed)) {
+            return false;
+        }
+        publish(ticket, std::forward<U>(item));
+        return true;
+    }
+
+public:
+
+    /**
+     * @brief Send, parking while the channel is full
+     * @return true if sent, false if the channel is (or got) closed
+     */
+    template<typename U>
+    bool send(U&& item) {
+        if (closed_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        if (!queue_) {
+            uint64_t ticket = turn_.fetch_add(1, std::memory_order_acq_rel);
+            if (!wait_done(ticket)) {
+                return false;
+            }
+            return handoff(ticket, std::forward<U>(item));
+        }
+
+        while (true) {
+            if (queue_->try_enqueue(std::forward<U>(item))) {
+                signal_readable();
+                return true;
+            }
+            uint32_t key = writable_.prepare_wait();
+            if (closed_.load(std::memory_order_acquire)) {
+                writable_.cancel_wait();
+                return false;
+            }
+            if (queue_->try_enqueue(std::forward<U>(item))) {
+                writable_.cancel_wait();
+                signal_readable();
+                return true;
+            }
+            writable_.wait(key);
+        }
+    }
+
+    /**
+     * @brief Receive without blocking
+     * @return the value, or std::nullopt if nothing is ready
+     */
+    std::optional<T> try_recv() {
+        if (!queue_) {
+            return take_slot();
+        }
+        std::optional<T> result = queue_->try_dequeue();
+        if (result) {
+            signal_writable();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Receive, parking while the channel is empty
+     * @return the value, or std::nullopt once closed and drained
+     */
+    std::optional<T> recv() {
+        while (true) {
+            if (auto result = try_recv()) {
+                return result;
+            }
+            uint32_t key = readable_.prepare_wait();
+            if (auto result = try_recv()) {
+                readable_.cancel_wait();
+                return result;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                readable_.cancel_wait();
+                // A sender may have slipped in before close
+                return try_recv();
+            }
+            if (!queue_) {
+                // A select parked on sending to us can now go ahead
+                notify_watchers();
+            }
+            readable_.wait(key);
+        }
+    }
+
+    /**
+     * @brief Close the channel and wake every waiter
+     */
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        readable_.notify_all();
+        writable_.notify_all();
+        notify_watchers();
+    }
+
+    bool closed() const noexcept {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Buffer capacity, 0 for rendezvous channels
+     */
+    size_t capacity() const noexcept {
+        return queue_ ? queue_->capacity() : 0;
+    }
+
+    /**
+     * @brief Get approximate number of buffered items
+     */
+    size_t size() const noexcept {
+        return queue_ ? queue_->size() : 0;
+    }
+};
+
+/**
+ * @brief select() case receiving from a channel
+ *
+ * Fires when a value arrives (out holds it) or when the channel is closed
+ * and drained (out is std::nullopt).
+ */
+template<typename T>
+class RecvCase {
+private:
+    Channel<T>& ch_;
+    std::optional<T>& out_;
+
+public:
+    RecvCase(Channel<T>& ch, std::optional<T>& out) : ch_(ch), out_(out) {}
+
+    bool try_fire() {
+        out_ = ch_.try_recv();
+        if (out_) {
+            return true;
+        }
+        if (ch_.closed()) {
+            out_ = ch_.try_recv();
+            return true;
+        }
+        return false;
+    }
+
+    void watch(EventCount* ev) { ch_.add_watcher(ev, true); }
+    void unwatch(EventCount* ev) { ch_.remove_watcher(ev, true); }
+};
+
+/**
+ * @brief select() case sending to a channel
+ *
+ * Fires when the value was sent. On a closed channel it fires without
+ * sending (where Go would panic); check closed() to tell the two apart.
+ */
+template<typename T>
+class SendCase {
+private:
+    Channel<T>& ch_;
+    T value_;
+    EventCount* ev_{nullptr};  // The select's, while watching
+
+public:
+    template<typename U>
+    SendCase(Channel<T>& ch, U&& value) : ch_(ch), value_(std::forward<U>(value)) {}
+
+    bool try_fire() {
+        if (ch_.closed()) {
+            return true;
+        }
+        return ch_.try_send_from(ev_, std::move(value_));
+    }
+
+    void watch(EventCount* ev) {
+        ev_ = ev;
+        ch_.add_watcher(ev, false);
+    }
+
+    void unwatch(EventCount* ev) {
+        ch_.remove_watcher(ev, false);
+        ev_ = nullptr;
+    }
+};
+
+template<typename T>
+RecvCase<T> recv_case(Channel<T>& ch, std::optional<T>& out) {
+    return RecvCase<T>(ch, out);
+}
+
+template<typename T, typename U>
+SendCase<T> send_case(Channel<T>& ch, U&& value) {
+    return SendCase<T>(ch, std::forward<U>(value));
+}
+
+namespace detail {
+
+inline uint32_t select_random() noexcept {
+    thread_local uint32_t state = static_cast<uint32_t>(
+        reinterpret_cast<uintptr_t>(&state) >> 4) | 1u;
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+template<typename Tuple, size_t... Is>
+int select_try_once(Tuple& cases, std::index_sequence<Is...>) {
+    constexpr size_t N = sizeof...(Is);
+    // Random starting case so no channel is starved
+    const size_t start = select_random() % N;
+    for (size_t k = 0; k < N; ++k) {
+        const size_t i = (start + k) % N;
+        bool fired = false;
+        ((i == Is ? (fired = std::get<Is>(cases).try_fire(), true) : false) || ...);
+        if (fired) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+} // namespace detail
+
+/**
+ * @brief Non-blocking select (select with a default case)
+ * @return index of the case that fired, -1 if none was ready
+ */
+template<typename... Cases>
+int try_select(Cases&&... cases) {
+    static_assert(sizeof...(Cases) > 0, "select needs at least one case");
+    auto tuple = std::forward_as_tuple(cases...);
+    return detail::select_try_once(tuple, std::index_sequence_for<Cases...>{});
+}
+
+/**
+ * @brief Block until one of the cases fires, chosen at random among ready ones
+ * @return index of the case that fired
+ */
+template<typename... Cases>
+int select(Cases&&... cases) {
+    static_assert(sizeof...(Cases) > 0, "select needs at least one case");
+    auto tuple = std::forward_as_tuple(cases...);
+    constexpr auto indices = std::index_sequence_for<Cases...>{};
+
+    int fired = detail::select_try_once(tuple, indices);
+    if (fired >= 0) {
+        return fired;
+    }
+
+    // Slow path: watch every channel, then retry before parking
+    EventCount ev;
+    (cases.watch(&ev), ...);
+    while (true) {
+        uint32_t key = ev.prepare_wait();
+        fired = detail::select_try_once(tuple, indices);
+        if (fired >= 0) {
+            ev.cancel_wait();
+            break;
+        }
+        ev.wait(key);
+    }
+    (cases.unwatch(&ev), ...);
+    return fired;
+}
+
+} // namespace lockfree
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "mpmc_queue.hpp"
+#include "spsc_ring_buffer.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief Checkpoint and restore of queue contents for warm restarts
+ *
+ * A checkpoint is a fixed header followed by the queued elements, oldest
+ * first, as raw bytes. Only trivially copyable element types are
+ * supported. Saving is one writev(), restoring one read() for the whole
+ * payload, so a restart is bound by I/O rather than rebuilding state.
+ *
+ * Quiesce producers and consumers before saving for an exact copy; a live
+ * queue is captured with its snapshot(), which skips slots that changed
+ * while being copied.
+ *
+ * The format is tied to the machine: element bytes are stored as is.
+ */
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t count;
+    uint64_t capacity;  // Capacity of the saved queue, informational
+};
+
+/**
+ * @brief Thrown when the queue fills up part way through a restore
+ *
+ * The elements before restored() are already in the queue and stay there.
+ */
+class CheckpointRestoreError : public std::runtime_error {
+private:
+    size_t restored_;
+
+public:
+    CheckpointRestoreError(const char* what, size_t restored)
+        : std::runtime_error(what), restored_(restored) {}
+
+    /**
+     * @brief Number of checkpoint elements enqueued before the queue filled up
+     */
+    size_t restored() const noexcept {
+        return restored_;
+    }
+};
+
+namespace detail {
+
+inline constexpr char CHECKPOINT_MAGIC[8] = {'L', 'F', 'Q', 'C', 'K', 'P', 'T', '\0'};
+inline constexpr uint32_t CHECKPOINT_VERSION = 1;
+
+/**
+ * @brief Uninitialized, suitably aligned room for count elements
+ *
+ * Elements are only ever filled by memcpy or read(), so T needs neither a
+ * default constructor nor a value-initialized buffer.
+ */
+template<typename T>
+class CheckpointBuffer {
+private:
+    struct Free {
+        void operator()(T* p) const noexcept {
+            ::operator delete(p, std::align_val_t{alignof(T)});
+        }
+    };
+
+    std::unique_ptr<T, Free> data_;
+    size_t count_;
+
+public:
+    explicit CheckpointBuffer(size_t count)
+        : data_(static_cast<T*>(::operator new(std::max<size_t>(count, 1) * sizeof(T),
+                                               std::align_val_t{alignof(T)})))
+        , count_(count)
+    {}
+
+    T* data() noexcept { return data_.get(); }
+    const T* data() const noexcept { return data_.get(); }
+    size_t size() const noexcept { return count_; }
+};
+
+inline void write_all(int fd, iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t n = ::writev(fd, iov, iovcnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "checkpoint write");
+        }
+        // Skip what was written, the kernel may stop short
+        size_t done = static_cast<size_t>(n);
+        while (iovcnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+            iov->iov_len -= done;
+        }
+    }
+}
+
+inline void read_all(int fd, void* buf, size_t len) {
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        ssize_t n = ::read(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "checkpoint read");
+        }
+        if (n == 0) {
+            throw std::runtime_error("checkpoint truncated");
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
+template<typename T>
+void write_checkpoint(int fd, const T* items, size_t count, size_t capacity) {
+    CheckpointHeader header{};
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.element_size = static_cast<uint32_t>(sizeof(T));
+    header.count = count;
+    header.capacity = capacity;
+
+    iovec iov[2];
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = const_cast<T*>(items);
+    iov[1].iov_len = count * sizeof(T);
+    write_all(fd, iov, count ? 2 : 1);
+}
+
+template<typename T>
+CheckpointBuffer<T> read_checkpoint(int fd, size_t free_slots) {
+    CheckpointHeader header;
+    read_all(fd, &header, sizeof(header));
+    if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CHECKPOINT_VERSION) {
+        throw std::runtime_error("not a queue checkpoint");
+    }
+    if (header.element_size != sizeof(T)) {
+        throw std::runtime_error("checkpoint element size mismatch");
+    }
+    if (header.count > free_slots) {
+        throw std::runtime_error("checkpoint does not fit in the queue");
+    }
+
+    CheckpointBuffer<T> items(header.count);
+    read_all(fd, items.data(), header.count * sizeof(T));
+    return items;
+}
+
+} // namespace detail
+
+/**
+ * @brief Write the contents of an MPMCQueue to fd
+ * @return number of elements saved
+ * @throws std::system_error on I/O failure
+ */
+template<typename T, typename Index, typename Slot>
+size_t save_checkpoint(int fd, const MPMCQueue<T, Index, Slot>& queue) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoints require trivially copyable T");
+    // Room for what is queued now; items arriving meanwhile are left out
+    detail::CheckpointBuffer<T> items(queue.size());
+    size_t count = queue.snapshot(items.data(), items.size());
+    detail::write_checkpoint(fd, items.data(), count, queue.capacity());
+    return count;
+}
+
+/**
+ * @brief Write the contents of a RingBuffer to fd
+ * @return number of elements saved
+ * @throws std::system_error on I/O failure
+ */
+template<typename T, typename Index, typename Slot>
+size_t save_checkpoint(int fd, const Lockfree::RingBuffer<T, Index, Slot>& ring) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoints require trivially copyable T");
+    detail::CheckpointBuffer<T> items(ring.size());
+    size_t count = ring.snapshot(items.data(), items.size());
+    detail::write_checkpoint(fd, items.data(), count, ring.capacity());
+    return count;
+}
+
+/**
+ * @brief Append the elements of a checkpoint read from fd to an MPMCQueue
+ *
+ * Restore into a quiesced queue. Free room is checked once, before the
+ * first element goes in, so a producer that fills the queue meanwhile
+ * leaves a partial restore: the elements enqueued so far stay, and their
+ * count is reported by the exception.
+ * @return number of elements restored
+ * @throws std::system_error on I/O failure, std::runtime_error on a bad
+ *         or mismatched checkpoint, CheckpointRestoreError if the queue
+ *         filled up part way through
+ */
+template<typename T, typename Index, typename Slot>
+size_t restore_checkpoint(int fd, MPMCQueue<T, Index, Slot>& queue) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoints require trivially copyable T");
+    detail::CheckpointBuffer<T> items = detail::read_checkpoint<T>(fd, queue.capacity() - queue.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!queue.try_enqueue(items.data()[i])) {
+            throw CheckpointRestoreError("queue filled up during restore", i);
+        }
+    }
+    return items.size();
+}
+
+/**
+ * @brief Append the elements of a checkpoint read from fd to a RingBuffer (as its producer)
+ *
+ * A running consumer only makes room, so the restore is all or nothing as
+ * long as no other thread writes to the ring.
+ * @return number of elements restored
+ * @throws std::system_error on I/O failure, std::runtime_error on a bad
+ *         or mismatched checkpoint, CheckpointRestoreError if the ring
+ *         filled up part way through
+ */
+template<typename T, typename Index, typename Slot>
+size_t restore_checkpoint(int fd, Lockfree::RingBuffer<T, Index, Slot>& ring) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoints require trivially copyable T");
+    detail::CheckpointBuffer<T> items = detail::read_checkpoint<T>(fd, ring.available());
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!ring.try_write(items.data()[i])) {
+            throw CheckpointRestoreError("ring filled up during restore", i);
+        }
+    }
+    return items.size();
+}
+
+#if defined(__linux__)
+/**
+ * @brief Create an anonymous in-memory file to hold a checkpoint
+ *
+ * The fd can be handed to a new process (e.g. across exec) and read back
+ * after lseek(fd, 0, SEEK_SET).
+ * @throws std::system_error if memfd_create fails
+ */
+inline int make_checkpoint_memfd(const char* name) {
+    int fd = ::memfd_create(name, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "memfd_create");
+    }
+    return fd;
+}
+#endif
+
+} // namespace lockfree
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "mpmc_queue.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief What the CoDel controller does to an item at a drop point
+ */
+enum class AqmAction {
+    Drop,  // Destroy the item and move on to the next one
+    Mark   // Hand the item out flagged as congested (ECN style)
+};
+
+/**
+ * @brief MPMCQueue with sojourn-time tracking and CoDel active queue management
+ *
+ * Every slot stores its enqueue timestamp. Consumers measure sojourn time
+ * on dequeue, and once the minimum sojourn has stayed above target for a
+ * full interval the controller starts dropping (or marking) items, at a
+ * rate that grows with sqrt(count) until the standing queue drains
+ * (Nichols & Jacobson, RFC 8289).
+ *
+ * Controller state is only touched on the dequeue path. With several
+ * consumers it is shared through relaxed atomics; races between them only
+ * nudge the drop schedule, they never lose or duplicate items.
+ *
+ * Clock can be swapped for a TSC-based clock with the same interface.
+ */
+template<typename T, typename Clock = std::chrono::steady_clock>
+class CoDelQueue {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Stamped {
+        T value;
+        int64_t enqueue_time;
+
+        template<typename U>
+        Stamped(U&& v, int64_t t) : value(std::forward<U>(v)), enqueue_time(t) {}
+    };
+
+    struct Dequeued {
+        std::optional<Stamped> item;
+        bool ok_to_drop{false};
+    };
+
+    MPMCQueue<Stamped> queue_;
+    const int64_t target_ns_;
+    const int64_t interval_ns_;
+    const AqmAction action_;
+
+    // Controller state (consumers only)
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> first_above_time_{0};
+    std::atomic<int64_t> drop_next_{0};
+    std::atomic<uint32_t> count_{0};
+    std::atomic<uint32_t> last_count_{0};
+    std::atomic<bool> dropping_{false};
+    std::atomic<int64_t> last_sojourn_ns_{0};
+
+    // Statistics
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> marked_{0};
+
+    static int64_t now_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+    }
+
+    int64_t control_law(int64_t t, uint32_t count) const noexcept {
+        return t + static_cast<int64_t>(interval_ns_ / std::sqrt(static_cast<double>(count)));
+    }
+
+    /**
+     * @brief Dequeue one item and decide whether sojourn has been high for an interval
+     */
+    Dequeued dequeue_and_check(int64_t now) {
+        Dequeued result;
+        result.item = queue_.try_dequeue();
+        if (!result.item) {
+            first_above_time_.store(0, std::memory_order_relaxed);
+            return result;
+        }
+
+        int64_t sojourn = now - result.item->enqueue_time;
+        last_sojourn_ns_.store(sojourn, std::memory_order_relaxed);
+
+        // Below target, or nothing queued behind us: not a standing queue
+        if (sojourn < target_ns_ || queue_.empty()) {
+            first_above_time_.store(0, std::memory_order_relaxed);
+            return result;
+        }
+
+        int64_t first_above = first_above_time_.load(std::memory_order_relaxed);
+        if (first_above == 0) {
+            first_above_time_.store(now + interval_ns_, std::memory_order_relaxed);
+        } else if (now >= first_above) {
+            result.ok_to_drop = true;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Apply the action at a drop point
+     * @return true if the item was consumed (dropped), false if it was marked
+     */
+    bool act(std::optional<Stamped>& item, bool& congested) {
+        count_.fetch_add(1, std::memory_order_relaxed);
+        if (action_ == AqmAction::Mark) {
+            marked_.fetch_add(1, std::memory_order_relaxed);
+            congested = true;
+            return false;
+        }
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        item.reset();
+        return true;
+    }
+
+    std::optional<T> dequeue(bool& congested) {
+        congested = false;
+        const int64_t now = now_ns();
+        Dequeued d = dequeue_and_check(now);
+        if (!d.item) {
+            dropping_.store(false, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        if (dropping_.load(std::memory_order_relaxed)) {
+            if (!d.ok_to_drop) {
+                // Sojourn went below target, leave dropping state
+                dropping_.store(false, std::memory_order_relaxed);
+            } else {
+                while (now >= drop_next_.load(std::memory_order_relaxed) &&
+                       dropping_.load(std::memory_order_relaxed)) {
+                    bool consumed = act(d.item, congested);
+                    drop_next_.store(control_law(drop_next_.load(std::memory_order_relaxed),
+                                                 count_.load(std::memory_order_relaxed)),
+                                     std::memory_order_relaxed);
+                    if (!consumed) {
+                        break;  // Marked item goes out
+                    }
+                    d = dequeue_and_check(now);
+                    if (!d.item) {
+                        dropping_.store(false, std::memory_order_relaxed);
+                        return std::nullopt;
+                    }
+                    if (!d.ok_to_drop) {
+                        dropping_.store(false, std::memory_order_relaxed);
+                    }
+                }
+            }
+        } else if (d.ok_to_drop) {
+            bool consumed = act(d.item, congested);
+            if (consumed) {
+                d = dequeue_and_check(now);
+            }
+            dropping_.store(true, std::memory_order_relaxed);
+
+            // Start near the previous drop rate if we were dropping recently
+            uint32_t count = count_.load(std::memory_order_relaxed);
+            uint32_t delta = count - last_count_.load(std::memory_order_relaxed);
+            if (delta > 1 &&
+                now - drop_next_.load(std::memory_order_relaxed) < 16 * interval_ns_) {
+                count = delta;
+            } else {
+                count = 1;
+            }
+            count_.store(count, std::memory_order_relaxed);
+            last_count_.store(count, std::memory_order_relaxed);
+            drop_next_.store(control_law(now, count), std::memory_order_relaxed);
+
+            if (!d.item) {
+                return std::nullopt;
+            }
+        }
+
+        return std::optional<T>(std::move(d.item->value));
+    }
+
+public:
+    /**
+     * @brief Construct queue
+     * @param capacity Desired capacity (rounded up to next power of 2)
+     * @param target Acceptable standing sojourn time (CoDel default 5 ms)
+     * @param interval Window over which sojourn must stay high (default 100 ms)
+     * @param action Drop or mark items at drop points
+     */
+    template<typename Rep1 = int64_t, typename Period1 = std::milli,
+             typename Rep2 = int64_t, typename Period2 = std::milli>
+    explicit CoDelQueue(size_t capacity,
+                        std::chrono::duration<Rep1, Period1> target = std::chrono::milliseconds(5),
+                        std::chrono::duration<Rep2, Period2> interval = std::chrono::milliseconds(100),
+                        AqmAction action = AqmAction::Drop)
+        : queue_(capacity < 2 ? 2 : capacity)
+        , target_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(target).count())
+        , interval_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count())
+        , action_(action)
+    {}
+
+    // Non-copyable, non-movable
+    CoDelQueue(const CoDelQueue&) = delete;
+    CoDelQueue& operator=(const CoDelQueue&) = delete;
+    CoDelQueue(CoDelQueue&&) = delete;
+    CoDelQueue& operator=(CoDelQueue&&) = delete;
+
+    /**
+     * @brief Attempt to enqueue an item, stamped with the current time
+     * @return true if successful, false if queue is full
+     */
+    template<typename U>
+    bool try_enqueue(U&& item) {
+        return queue_.try_emplace(std::forward<U>(item), now_ns());
+    }
+
+    /**
+     * @brief Attempt to dequeue an item, applying AQM
+     * @return the item, std::nullopt if empty (or everything left was dropped)
+     */
+    std::optional<T> try_dequeue() {
+        bool congested;
+        return dequeue(congested);
+    }
+
+    /**
+     * @brief Attempt to dequeue an item, reporting marks
+     * @param congested Set to true if the item was marked (AqmAction::Mark)
+     * @return true if successful, false if empty
+     */
+    bool try_dequeue(T& out, bool& congested) {
+        auto item = dequeue(congested);
+        if (!item) {
+            return false;
+        }
+        out = std::move(*item);
+        return true;
+    }
+
+    /**
+     * @brief Sojourn time of the most recently dequeued item
+     */
+    std::chrono::nanoseconds last_sojourn() const noexcept {
+        return std::chrono::nanoseconds(last_sojourn_ns_.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Check if the controller is currently in dropping state
+     */
+    bool dropping() const noexcept {
+        return dropping_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t marked() const noexcept {
+        return marked_.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept {
+        return queue_.empty();
+    }
+
+    size_t size() const noexcept {
+        return queue_.size();
+    }
+
+    size_t capacity() const noexcept {
+        return queue_.capacity();
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "mpmc_queue.hpp"
+#include "bucket_queue.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief What to do with a task whose deadline has already passed
+ */
+enum class ExpiredPolicy {
+    Drop,   // Discard it, counted in expired()
+    Demote  // Run it only when no on-time work is left
+};
+
+/**
+ * @brief Concurrent earliest-deadline-first queue for a worker pool
+ *
+ * Two levels:
+ * - a local min-heap per worker, pushed and popped only by its owner
+ * - a shared MonotoneBucketQueue keyed by deadline for global balance,
+ *   which any thread can submit to and every worker pops from
+ *
+ * Workers take whichever is earlier at slice granularity, so ordering
+ * across the two levels is EDF up to one slice_width. A local heap that
+ * grows past spill_threshold overflows into the shared level so idle
+ * workers can pick up its work.
+ */
+template<typename T, typename Clock = std::chrono::steady_clock>
+class DeadlineQueue {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Task {
+        int64_t deadline;
+        T value;
+
+        template<typename U>
+        Task(int64_t d, U&& v) : deadline(d), value(std::forward<U>(v)) {}
+    };
+
+    struct Later {
+        bool operator()(const Task& a, const Task& b) const noexcept {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        std::vector<Task> heap;  // Owner only
+    };
+
+    MonotoneBucketQueue<Task> shared_;
+    MPMCQueue<T> demoted_;
+    std::vector<Worker> workers_;
+    const ExpiredPolicy policy_;
+    const size_t spill_threshold_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> expired_{0};
+
+    static int64_t to_ns(typename Clock::time_point t) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            t.time_since_epoch()).count();
+    }
+
+    std::optional<Task> pop_local(Worker& w) {
+        if (w.heap.empty()) {
+            return std::nullopt;
+        }
+        std::pop_heap(w.heap.begin(), w.heap.end(), Later{});
+        std::optional<Task> task(std::move(w.heap.back()));
+        w.heap.pop_back();
+        return task;
+    }
+
+    /**
+     * @brief Take the earlier of the local top and the shared front
+     *
+     * Shared buckets are FIFO within a slice, so the two levels are compared
+     * at slice granularity: the shared level goes first only when its
+     * earliest non-empty slice is no later than the local top's.
+     */
+    std::optional<Task> pop_earliest(Worker& w) {
+        if (!w.heap.empty()) {
+            const uint64_t local = static_cast<uint64_t>(w.heap.front().deadline);
+            // Shared items are no earlier than the current slice
+            if (local < shared_.current_key()) {
+                return pop_local(w);
+            }
+            std::optional<uint64_t> front = shared_.front_key();
+            const uint64_t width = shared_.slice_width();
+            if (!front || *front / width > local / width) {
+                return pop_local(w);
+            }
+        }
+        if (auto task = shared_.try_pop()) {
+            return task;
+        }
+        return pop_local(w);
+    }
+
+public:
+    /**
+     * @brief Construct queue
+     * @param workers Number of workers (local heaps)
+     * @param num_buckets Number of deadline slices in the shared level
+     * @param bucket_capacity Capacity of each shared slice
+     * @param slice_width Deadline range covered by one shared slice
+     * @param policy Drop or demote expired tasks
+     * @param spill_threshold Local heap size beyond which pushes go shared
+     * @param demoted_capacity Capacity of the demoted (late) task queue
+     */
+    DeadlineQueue(size_t workers, size_t num_buckets, size_t bucket_capacity,
+                  typename Clock::duration slice_width,
+                  ExpiredPolicy policy = ExpiredPolicy::Drop,
+                  size_t spill_threshold = 64,
+                  size_t demoted_capacity = 1024)
+        : shared_(num_buckets, bucket_capacity,
+                  static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      slice_width).count()),
+                  static_cast<uint64_t>(to_ns(Clock::now())))
+        , demoted_(demoted_capacity < 2 ? 2 : demoted_capacity)
+        , workers_(workers)
+        , policy_(policy)
+        , spill_threshold_(spill_threshold)
+    {
+        for (auto& w : workers_) {
+            w.heap.reserve(spill_threshold_);
+        }
+    }
+
+    // Non-copyable, non-movable
+    DeadlineQueue(const DeadlineQueue&) = delete;
+    DeadlineQueue& operator=(const DeadlineQueue&) = delete;
+    DeadlineQueue(DeadlineQueue&&) = delete;
+    DeadlineQueue& operator=(DeadlineQueue&&) = delete;
+
+    /**
+     * @brief Submit a task to the shared level (any thread)
+     * @return false if its slice is full or the deadline is beyond the horizon;
+     *         item is only moved from on success
+     */
+    template<typename U>
+    bool try_submit(typename Clock::time_point deadline, U&& item) {
+        int64_t dl = to_ns(deadline);
+        // The Task is built in the claimed slot, so a rejected item is left untouched
+        return shared_.try_emplace(static_cast<uint64_t>(dl), dl, std::forward<U>(item));
+    }
+
+    /**
+     * @brief Push a task to a worker's local heap (that worker's thread only)
+     *
+     * Spills to the shared level once the heap holds spill_threshold tasks.
+     */
+    template<typename U>
+    void push_local(size_t worker, typename Clock::time_point deadline, U&& item) {
+        Worker& w = workers_[worker];
+        int64_t dl = to_ns(deadline);
+        Task task{dl, std::forward<U>(item)};
+        // try_push leaves task intact when it fails, so it can still go to the heap
+        if (w.heap.size() >= spill_threshold_ &&
+            shared_.try_push(static_cast<uint64_t>(dl), std::move(task))) {
+            return;
+        }
+        w.heap.push_back(std::move(task));
+        std::push_heap(w.heap.begin(), w.heap.end(), Later{});
+    }
+
+    /**
+     * @brief Pop the most urgent task (that worker's thread only)
+     *
+     * Expired tasks are dropped or demoted according to the policy. Demoted
+     * tasks are handed out only when no on-time task is available.
+     * @return true if successful, false if there is no work
+     */
+    bool try_pop(size_t worker, T& out) {
+        Worker& w = workers_[worker];
+        const int64_t now = to_ns(Clock::now());
+
+        while (auto task = pop_earliest(w)) {
+            if (task->deadline >= now) {
+                out = std::move(task->value);
+                return true;
+            }
+
+            expired_.fetch_add(1, std::memory_order_relaxed);
+            if (policy_ == ExpiredPolicy::Demote) {
+                // A full demoted queue degrades to dropping
+                demoted_.try_enqueue(std::move(task->value));
+            }
+        }
+
+        return demoted_.try_dequeue(out);
+    }
+
+    /**
+     * @brief Number of tasks found past their deadline at pop time
+     */
+    uint64_t expired() const noexcept {
+        return expired_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get local heap size (that worker's thread only)
+     */
+    size_t local_size(size_t worker) const noexcept {
+        return workers_[worker].heap.size();
+    }
+
+    /**
+     * @brief Get approximate number of tasks in the shared and demoted levels
+     */
+    size_t shared_size() const noexcept {
+        return shared_.size() + demoted_.size();
+    }
+
+    size_t workers() const noexcept {
+        return workers_.size();
+    }
+};
+
+} // namespace lockfree
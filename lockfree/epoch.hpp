@@ -0,0 +1,326 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace lockfree {
+
+/**
+ * @brief Epoch-based memory reclamation (Fraser)
+ *
+ * Threads wrap every access to shared nodes in a critical section
+ * (EpochDomain::Guard). Unlinked nodes are retired into one of three limbo
+ * lists tagged with the global epoch, and freed once the epoch has moved
+ * three steps past the tag: by then every thread that could have seen the
+ * node has left its critical section.
+ *
+ * The epoch advances only when every active thread has announced the
+ * current one, so a thread stalled inside a critical section delays
+ * reclamation (but never blocks other operations).
+ *
+ * Per-thread records are reused after thread exit; whatever a thread left
+ * in limbo is inherited by the next thread to take its record, or freed
+ * when the domain is destroyed. A thread keeps one record per domain it
+ * has used, so guards on several domains can be held at once.
+ */
+class EpochDomain {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr uint64_t INACTIVE = ~uint64_t(0);
+    static constexpr size_t ADVANCE_INTERVAL = 64;  // Retires between advance attempts
+
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+    };
+
+    struct Limbo {
+        std::vector<Retired> items;
+        uint64_t tag{0};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Record {
+        std::atomic<uint64_t> epoch{INACTIVE};  // Announced epoch, read by advancers
+        std::atomic<bool> in_use{true};
+        Record* next{nullptr};                  // Immutable once published
+
+        // Owner only
+        uint32_t nesting{0};
+        size_t retires{0};
+        Limbo limbo[3];
+    };
+
+    // A thread's record in one domain. The id tells a live domain from a
+    // destroyed one that left a new domain at the same address.
+    struct LocalEntry {
+        EpochDomain* domain;
+        uint64_t id;
+        Record* record;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> global_epoch_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<Record*> records_{nullptr};
+    const uint64_t id_;
+
+    // Ids of live domains. Thread exit and domain destruction both hold the
+    // mutex, so a record is never released into a domain being torn down.
+    static std::mutex& registry_mutex() {
+        static std::mutex mtx;
+        return mtx;
+    }
+
+    static std::vector<uint64_t>& live_ids() {
+        static std::vector<uint64_t> ids;
+        return ids;
+    }
+
+    static bool is_live(uint64_t id) {
+        const auto& ids = live_ids();
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    }
+
+    static uint64_t register_domain() {
+        static std::atomic<uint64_t> next_id{1};
+        uint64_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        live_ids().push_back(id);
+        return id;
+    }
+
+    static void free_all(Limbo& limbo) noexcept {
+        for (const Retired& r : limbo.items) {
+            r.deleter(r.ptr);
+        }
+        limbo.items.clear();
+    }
+
+    static void collect(Record& rec, uint64_t epoch) noexcept {
+        for (Limbo& limbo : rec.limbo) {
+            if (!limbo.items.empty() && limbo.tag + 3 <= epoch) {
+                free_all(limbo);
+            }
+        }
+    }
+
+    /**
+     * @brief Advance the global epoch if every active thread has caught up
+     */
+    bool try_advance() noexcept {
+        uint64_t epoch = global_epoch_.load(std::memory_order_seq_cst);
+        for (Record* r = records_.load(std::memory_order_acquire); r; r = r->next) {
+            uint64_t announced = r->epoch.load(std::memory_order_seq_cst);
+            if (announced != INACTIVE && announced != epoch) {
+                return false;
+            }
+        }
+        return global_epoch_.compare_exchange_strong(epoch, epoch + 1,
+                                                     std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed);
+    }
+
+    Record* acquire_record() {
+        for (Record* r = records_.load(std::memory_order_acquire); r; r = r->next) {
+            bool expected = false;
+            if (!r->in_use.load(std::memory_order_relaxed) &&
+                r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return r;
+            }
+        }
+
+        Record* rec = new Record();
+        Record* head = records_.load(std::memory_order_relaxed);
+        do {
+            rec->next = head;
+        } while (!records_.compare_exchange_weak(head, rec, std::memory_order_release,
+                                                 std::memory_order_relaxed));
+        return rec;
+    }
+
+    void release_record(Record* rec) noexcept {
+        collect(*rec, global_epoch_.load(std::memory_order_acquire));
+        rec->in_use.store(false, std::memory_order_release);
+    }
+
+    struct Holder {
+        std::vector<LocalEntry> entries;
+
+        ~Holder() {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            for (const LocalEntry& e : entries) {
+                if (is_live(e.id)) {
+                    e.domain->release_record(e.record);
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Take a record for this thread and drop entries of dead domains
+     */
+    Record& attach(Holder& holder) {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        auto& entries = holder.entries;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const LocalEntry& e) { return !is_live(e.id); }),
+                      entries.end());
+        Record* rec = acquire_record();
+        entries.push_back(LocalEntry{this, id_, rec});
+        return *rec;
+    }
+
+    /**
+     * @brief The calling thread's record in this domain, taken on first use
+     */
+    Record& local() {
+        thread_local Holder holder;
+        for (const LocalEntry& e : holder.entries) {
+            if (e.domain == this && e.id == id_) {
+                return *e.record;
+            }
+        }
+        return attach(holder);
+    }
+
+public:
+    /**
+     * @brief RAII critical section; nodes read inside stay valid until it ends
+     *
+     * Guards nest.
+     */
+    class Guard {
+    private:
+        EpochDomain& domain_;
+        Record& rec_;
+
+    public:
+        explicit Guard(EpochDomain& domain) : domain_(domain), rec_(domain.local()) {
+            if (rec_.nesting++ == 0) {
+                uint64_t epoch = domain_.global_epoch_.load(std::memory_order_relaxed);
+                rec_.epoch.store(epoch, std::memory_order_relaxed);
+                // Announce before reading any shared pointer
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                collect(rec_, epoch);
+            }
+        }
+
+        ~Guard() {
+            if (--rec_.nesting == 0) {
+                rec_.epoch.store(INACTIVE, std::memory_order_release);
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    EpochDomain() : id_(register_domain()) {}
+
+    ~EpochDomain() {
+        {
+            // Exiting threads stop handing records back to us from here on
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            auto& ids = live_ids();
+            ids.erase(std::find(ids.begin(), ids.end(), id_));
+        }
+        Record* r = records_.load(std::memory_order_acquire);
+        while (r) {
+            Record* next = r->next;
+            for (Limbo& limbo : r->limbo) {
+                free_all(limbo);
+            }
+            delete r;
+            r = next;
+        }
+    }
+
+    // Non-copyable, non-movable
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+    EpochDomain(EpochDomain&&) = delete;
+    EpochDomain& operator=(EpochDomain&&) = delete;
+
+    /**
+     * @brief Hand an unlinked node over for deferred deletion
+     *
+     * The node must already be unreachable for threads that start a
+     * critical section from now on.
+     */
+    void retire(void* ptr, void (*deleter)(void*)) {
+        Record& rec = local();
+
+        // The current epoch is never older than the one the unlink happened in
+        uint64_t epoch = global_epoch_.load(std::memory_order_seq_cst);
+        Limbo& limbo = rec.limbo[epoch % 3];
+        if (limbo.tag != epoch) {
+            free_all(limbo);  // Tagged at most epoch - 3, safe now
+            limbo.tag = epoch;
+        }
+        limbo.items.push_back(Retired{ptr, deleter});
+
+        if (++rec.retires % ADVANCE_INTERVAL == 0) {
+            try_advance();
+            collect(rec, global_epoch_.load(std::memory_order_acquire));
+        }
+    }
+
+    /**
+     * @brief Advance the epoch as far as current readers allow and free what
+     *        this thread retired that became safe
+     *
+     * retire() only tries every ADVANCE_INTERVAL calls, which suits a steady
+     * stream of small nodes. Callers that retire rarely but retire large
+     * blocks call this right after, so the memory does not wait for 64 more
+     * retires. Call outside any Guard on this domain.
+     */
+    void reclaim() {
+        Record& rec = local();
+        // Three steps past the newest tag frees everything in limbo
+        for (int i = 0; i < 3 && try_advance(); ++i) {
+        }
+        collect(rec, global_epoch_.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Process-wide domain used by EpochReclaimer
+     */
+    static EpochDomain& global() {
+        static EpochDomain domain;
+        return domain;
+    }
+};
+
+/**
+ * @brief Reclamation policy for node-based containers, backed by EpochDomain::global()
+ *
+ * A policy provides a Guard type held around each operation and a static
+ * retire() for unlinked nodes.
+ */
+struct EpochReclaimer {
+    class Guard {
+    private:
+        EpochDomain::Guard guard_;
+
+    public:
+        Guard() : guard_(EpochDomain::global()) {}
+    };
+
+    template<typename Node>
+    static void retire(Node* node) {
+        EpochDomain::global().retire(node, [](void* p) {
+            delete static_cast<Node*>(p);
+        });
+    }
+
+    /**
+     * @brief Free this thread's retired nodes as soon as readers allow
+     */
+    static void reclaim() {
+        EpochDomain::global().reclaim();
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace lockfree {
+
+/**
+ * @brief Event count for parking threads on a lock-free condition
+ *
+ * Waiters park on a futex (std::atomic::wait) and notifiers only touch it
+ * when someone is actually waiting, so fast paths stay a fence plus a load.
+ *
+ * Waiter:
+ *   auto key = ev.prepare_wait();
+ *   if (condition()) { ev.cancel_wait(); } else { ev.wait(key); }
+ *
+ * Notifier:
+ *   make condition true; ev.notify_one();
+ */
+class EventCount {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> waiters_{0};
+
+public:
+    EventCount() = default;
+    EventCount(const EventCount&) = delete;
+    EventCount& operator=(const EventCount&) = delete;
+
+    /**
+     * @brief Announce intent to wait, must be followed by wait() or cancel_wait()
+     * @return key to pass to wait()
+     */
+    uint32_t prepare_wait() noexcept {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        // Pairs with the fence in notify: either we see the new condition
+        // or the notifier sees our waiter count
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    void cancel_wait() noexcept {
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Park until notified after prepare_wait() returned key
+     */
+    void wait(uint32_t key) noexcept {
+        while (epoch_.load(std::memory_order_acquire) == key) {
+            epoch_.wait(key, std::memory_order_acquire);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify_one() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_one();
+        }
+    }
+
+    void notify_all() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_all();
+        }
+    }
+
+    /**
+     * @brief Check for parked or about-to-park threads (approximate)
+     */
+    bool has_waiters() const noexcept {
+        return waiters_.load(std::memory_order_relaxed) != 0;
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <initializer_list>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "spsc_ring_buffer.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief Fan-in merger over up to 64 producer-private SPSC rings
+ *
+ * Each producer owns one Lockfree::RingBuffer. A shared 64-bit bitmap
+ * marks which rings may hold data; the consumer visits only the set bits,
+ * so a poll costs O(active inputs) instead of O(inputs).
+ *
+ * A producer publishes its item, then sets its bit if it is clear. The
+ * consumer clears a bit only after draining that ring and rechecks the
+ * ring afterwards (Dekker-style, both sides fence), so an item is never
+ * left behind a clear bit. While the bit stays set the producer only
+ * reads the bitmap, so producers do not contend with each other.
+ *
+ * Inputs are served round-robin, each taking up to its weight in items
+ * per visit (weighted round-robin; all weights 1 by default).
+ */
+template<typename T>
+class FanIn {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t MAX_INPUTS = 64;
+
+    std::vector<std::unique_ptr<Lockfree::RingBuffer<T>>> inputs_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> active_{0};
+
+    // Consumer private
+    alignas(CACHE_LINE_SIZE) size_t cursor_{MAX_INPUTS - 1};  // Last input served
+    std::vector<size_t> weights_;
+
+    static uint64_t bit(size_t input) noexcept {
+        return uint64_t(1) << input;
+    }
+
+    /**
+     * @brief Active inputs ordered to start just after the last one served
+     */
+    void split_round_robin(uint64_t active, uint64_t& first, uint64_t& second) const noexcept {
+        const size_t start = cursor_ + 1;
+        const uint64_t from_start = start >= MAX_INPUTS ? 0 : ~uint64_t(0) << start;
+        first = active & from_start;
+        second = active & ~from_start;
+    }
+
+    /**
+     * @brief Clear an input's bit after draining it, restoring it if data raced in
+     */
+    void retire_input(size_t input) noexcept {
+        active_.fetch_and(~bit(input), std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!inputs_[input]->empty()) {
+            active_.fetch_or(bit(input), std::memory_order_relaxed);
+        }
+    }
+
+public:
+    /**
+     * @brief Construct fan-in
+     * @param inputs Number of producers (at most 64)
+     * @param capacity Capacity of each producer's ring
+     * @throws std::invalid_argument if inputs exceeds 64
+     */
+    FanIn(size_t inputs, size_t capacity)
+        : weights_(inputs, 1)
+    {
+        if (inputs > MAX_INPUTS) {
+            throw std::invalid_argument("FanIn supports at most 64 inputs");
+        }
+        inputs_.reserve(inputs);
+        for (size_t i = 0; i < inputs; ++i) {
+            inputs_.emplace_back(new Lockfree::RingBuffer<T>(capacity));
+        }
+    }
+
+    // Non-copyable, non-movable
+    FanIn(const FanIn&) = delete;
+    FanIn& operator=(const FanIn&) = delete;
+    FanIn(FanIn&&) = delete;
+    FanIn& operator=(FanIn&&) = delete;
+
+    /**
+     * @brief Try to write an item (producer of that input only)
+     * @return true if successful, false if the input's ring is full
+     */
+    template<typename U>
+    bool try_write(size_t input, U&& item) {
+        if (!inputs_[input]->try_write(std::forward<U>(item))) {
+            return false;
+        }
+
+        // Publish before checking the bit, pairs with retire_input()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!(active_.load(std::memory_order_relaxed) & bit(input))) {
+            active_.fetch_or(bit(input), std::memory_order_release);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Set how many items an input may hand over per visit (consumer only)
+     */
+    void set_weight(size_t input, size_t weight) noexcept {
+        weights_[input] = weight ? weight : 1;
+    }
+
+    /**
+     * @brief Service active inputs in round-robin order (consumer only)
+     * @param fn Called as fn(input, T&&) for each item
+     * @param max_items Stop after this many items
+     * @return number of items handed to fn
+     */
+    template<typename Fn>
+    size_t poll(Fn&& fn, size_t max_items = SIZE_MAX) {
+        size_t served = 0;
+        uint64_t first, second;
+        split_round_robin(active_.load(std::memory_order_acquire), first, second);
+
+        for (uint64_t* set : {&first, &second}) {
+            while (*set && served < max_items) {
+                const size_t input = static_cast<size_t>(__builtin_ctzll(*set));
+                *set &= *set - 1;
+                cursor_ = input;
+
+                Lockfree::RingBuffer<T>& ring = *inputs_[input];
+                size_t quota = weights_[input];
+                while (quota > 0 && served < max_items) {
+                    auto item = ring.try_read();
+                    if (!item) {
+                        retire_input(input);
+                        break;
+                    }
+                    fn(input, std::move(*item));
+                    ++served;
+                    --quota;
+                }
+            }
+        }
+        return served;
+    }
+
+    /**
+     * @brief Try to read one item from the next active input (consumer only)
+     * @return true if successful, false if every input was empty
+     */
+    bool try_read(T& out) {
+        return poll([&](size_t, T&& item) { out = std::move(item); }, 1) == 1;
+    }
+
+    /**
+     * @brief Bitmap of inputs that may hold data (approximate)
+     */
+    uint64_t active() const noexcept {
+        return active_.load(std::memory_order_relaxed);
+    }
+
+    size_t inputs() const noexcept {
+        return inputs_.size();
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "spsc_ring_buffer.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief Join-shortest-queue dispatcher over per-worker SPSC rings
+ *
+ * One dispatcher thread feeds N Lockfree::RingBuffers, one per worker, so
+ * workers keep contention-free inputs. Instead of round-robin, each item
+ * goes to the emptier of two randomly sampled rings (power of two
+ * choices), which keeps a slow worker from building a backlog while the
+ * others idle.
+ *
+ * With sticky_burst > 0 the dispatcher keeps sending to the last chosen
+ * ring for up to that many consecutive items, as long as that ring stays
+ * below the occupancy it was chosen at plus the burst. Bursts of related
+ * items then stay on one worker and the sampling cost is amortized.
+ */
+template<typename T>
+class FanOut {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<std::unique_ptr<Lockfree::RingBuffer<T>>> outputs_;
+    const size_t sticky_burst_;
+
+    // Dispatcher private
+    alignas(CACHE_LINE_SIZE) uint32_t rng_{0x9E3779B9u};
+    size_t sticky_target_{0};
+    size_t sticky_left_{0};
+    size_t sticky_limit_{0};  // Occupancy at which the sticky target is dropped
+
+    uint32_t next_random() noexcept {
+        // xorshift32
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        return rng_;
+    }
+
+    /**
+     * @brief Pick the emptier of two random outputs, and report the other one
+     */
+    size_t choose(size_t& other) noexcept {
+        const size_t n = outputs_.size();
+        size_t a = next_random() % n;
+        size_t b = n > 1 ? (a + 1 + next_random() % (n - 1)) % n : a;
+        if (outputs_[b]->size() < outputs_[a]->size()) {
+            std::swap(a, b);
+        }
+        other = b;
+        return a;
+    }
+
+public:
+    /**
+     * @brief Construct dispatcher
+     * @param outputs Number of workers
+     * @param capacity Capacity of each worker's ring
+     * @param sticky_burst Items to keep on one target before resampling (0 disables)
+     */
+    FanOut(size_t outputs, size_t capacity, size_t sticky_burst = 0)
+        : sticky_burst_(sticky_burst)
+    {
+        outputs_.reserve(outputs);
+        for (size_t i = 0; i < outputs; ++i) {
+            outputs_.emplace_back(new Lockfree::RingBuffer<T>(capacity));
+        }
+    }
+
+    // Non-copyable, non-movable
+    FanOut(const FanOut&) = delete;
+    FanOut& operator=(const FanOut&) = delete;
+    FanOut(FanOut&&) = delete;
+    FanOut& operator=(FanOut&&) = delete;
+
+    /**
+     * @brief Dispatch an item to a lightly loaded worker (dispatcher only)
+     * @param target Set to the chosen worker on success
+     * @return true if successful, false if both sampled rings were full
+     */
+    template<typename U>
+    bool try_dispatch(U&& item, size_t& target) {
+        if (sticky_left_ > 0) {
+            Lockfree::RingBuffer<T>& ring = *outputs_[sticky_target_];
+            if (ring.size() < sticky_limit_ && ring.try_write(std::forward<U>(item))) {
+                --sticky_left_;
+                target = sticky_target_;
+                return true;
+            }
+            sticky_left_ = 0;
+        }
+
+        size_t other;
+        size_t chosen = choose(other);
+        if (!outputs_[chosen]->try_write(std::forward<U>(item))) {
+            if (other == chosen || !outputs_[other]->try_write(std::forward<U>(item))) {
+                return false;
+            }
+            chosen = other;
+        }
+
+        if (sticky_burst_ > 0) {
+            sticky_target_ = chosen;
+            sticky_left_ = sticky_burst_ - 1;
+            sticky_limit_ = outputs_[chosen]->size() + sticky_burst_;
+        }
+        target = chosen;
+        return true;
+    }
+
+    /**
+     * @brief Dispatch an item to a lightly loaded worker (dispatcher only)
+     * @return true if successful, false if both sampled rings were full
+     */
+    template<typename U>
+    bool try_dispatch(U&& item) {
+        size_t target;
+        return try_dispatch(std::forward<U>(item), target);
+    }
+
+    /**
+     * @brief Try to read the next item for a worker (that worker only)
+     * @return true if successful, false if its ring is empty
+     */
+    bool try_read(size_t worker, T& out) {
+        return outputs_[worker]->try_read(out);
+    }
+
+    /**
+     * @brief Try to read the next item for a worker (that worker only)
+     * @return std::optional containing the item, std::nullopt if its ring is empty
+     */
+    std::optional<T> try_read(size_t worker) {
+        return outputs_[worker]->try_read();
+    }
+
+    /**
+     * @brief Get approximate occupancy of a worker's ring
+     */
+    size_t size(size_t worker) const noexcept {
+        return outputs_[worker]->size();
+    }
+
+    size_t outputs() const noexcept {
+        return outputs_.size();
+    }
+};
+
+} // namespace lockfree
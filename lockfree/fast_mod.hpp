@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lockfree {
+
+/**
+ * @brief Tag for constructors that keep the requested capacity as is
+ *
+ * Without it, capacities are rounded up to a power of 2. A capacity that is
+ * not a power of 2 also needs the FastMod slot policy.
+ */
+struct exact_capacity_t {
+    explicit exact_capacity_t() = default;
+};
+
+inline constexpr exact_capacity_t exact_capacity{};
+
+namespace detail {
+
+inline constexpr bool is_power_of_2(uint64_t n) noexcept {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+} // namespace detail
+
+/**
+ * @brief Slot policy: reduce a ring position by masking (power-of-2 divisors only)
+ *
+ * The default for MPMCQueue and RingBuffer; one AND per index computation.
+ */
+class PowerOf2Mod {
+private:
+    uint64_t mask_;
+
+public:
+    explicit PowerOf2Mod(uint64_t divisor) noexcept : mask_(divisor - 1) {}
+
+    /**
+     * @brief a % divisor
+     */
+    uint64_t operator()(uint64_t a) const noexcept {
+        return a & mask_;
+    }
+
+    uint64_t divisor() const noexcept {
+        return mask_ + 1;
+    }
+
+    bool is_power_of_2() const noexcept {
+        return detail::is_power_of_2(mask_ + 1);
+    }
+};
+
+/**
+ * @brief Slot policy: reduce a ring position modulo any divisor without a division
+ *
+ * Lemire's fastmod (Lemire, Kaser & Kurz, "Faster Remainder by Direct
+ * Computation"): one precomputed 128-bit reciprocal, then two
+ * multiplications per call. Selected at compile time through the queue's
+ * Slot parameter, so power-of-2 queues never pay for it.
+ */
+class FastMod {
+private:
+    uint64_t divisor_;
+#if defined(__SIZEOF_INT128__)
+    __uint128_t reciprocal_;  // ceil(2^128 / divisor_)
+#endif
+
+public:
+    explicit FastMod(uint64_t divisor) noexcept
+        : divisor_(divisor)
+#if defined(__SIZEOF_INT128__)
+        , reciprocal_(~__uint128_t(0) / divisor + 1)
+#endif
+    {}
+
+    /**
+     * @brief a % divisor
+     */
+    uint64_t operator()(uint64_t a) const noexcept {
+#if defined(__SIZEOF_INT128__)
+        // Also exact for powers of 2; for divisor 1 the reciprocal wraps to 0
+        // High 64 bits of the 192-bit product (reciprocal_ * a mod 2^128) * divisor_
+        __uint128_t low = reciprocal_ * a;
+        __uint128_t bottom = (static_cast<__uint128_t>(static_cast<uint64_t>(low)) * divisor_) >> 64;
+        __uint128_t top = static_cast<__uint128_t>(static_cast<uint64_t>(low >> 64)) * divisor_;
+        return static_cast<uint64_t>((bottom + top) >> 64);
+#else
+        return a % divisor_;
+#endif
+    }
+
+    uint64_t divisor() const noexcept {
+        return divisor_;
+    }
+
+    bool is_power_of_2() const noexcept {
+        return detail::is_power_of_2(divisor_);
+    }
+};
+
+} // namespace lockfree
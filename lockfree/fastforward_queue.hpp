@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace lockfree {
+
+/**
+ * @brief FastForward SPSC queue for pointers (Giacomoni et al.)
+ *
+ * An empty slot holds nullptr. Producer and consumer keep private indices
+ * and synchronize only through the slots, so no shared control variable
+ * bounces between cores, only the data lines themselves.
+ *
+ * Temporal slipping: call slip() from the consumer at the start of a batch
+ * to let the producer get a few cache lines ahead, so both sides do not
+ * work on the same line at once.
+ */
+template<typename T>
+class FastForwardQueue {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t SLOTS_PER_LINE = CACHE_LINE_SIZE / sizeof(std::atomic<T*>);
+    static constexpr size_t DANGER = 2 * SLOTS_PER_LINE;  // Closer than this is too close
+    static constexpr size_t GOOD = 6 * SLOTS_PER_LINE;    // Distance to slip back to
+
+    static size_t next_power_of_2(size_t n) {
+        if (n == 0) return 1;
+        --n;
+        n |= n >> 1;
+        n |= n >> 2;
+        n |= n >> 4;
+        n |= n >> 8;
+        n |= n >> 16;
+        n |= n >> 32;
+        return n + 1;
+    }
+
+    static void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+
+    std::atomic<T*>* slots_;
+    const size_t capacity_;
+    const size_t mask_;
+
+    // Producer private
+    alignas(CACHE_LINE_SIZE) size_t head_{0};
+
+    // Consumer private
+    alignas(CACHE_LINE_SIZE) size_t tail_{0};
+    char padding_[CACHE_LINE_SIZE - sizeof(size_t)];
+
+    /**
+     * @brief Approximate producer lead, probed through the slots (consumer only)
+     */
+    size_t distance() const noexcept {
+        // The producer is at least d ahead if slot tail_ + d - 1 is full
+        size_t d = GOOD;
+        while (d > 0 &&
+               slots_[(tail_ + d - 1) & mask_].load(std::memory_order_relaxed) == nullptr) {
+            d /= 2;
+        }
+        return d;
+    }
+
+public:
+    /**
+     * @brief Construct queue with given capacity
+     * @param capacity Desired capacity (rounded up to a power of 2, at least
+     *        enough for the slip distance)
+     */
+    explicit FastForwardQueue(size_t capacity)
+        : capacity_(next_power_of_2(capacity < 2 * GOOD ? 2 * GOOD : capacity))
+        , mask_(capacity_ - 1)
+    {
+        slots_ = static_cast<std::atomic<T*>*>(
+            ::operator new(sizeof(std::atomic<T*>) * capacity_,
+                           std::align_val_t{CACHE_LINE_SIZE}));
+        for (size_t i = 0; i < capacity_; ++i) {
+            new (&slots_[i]) std::atomic<T*>(nullptr);
+        }
+    }
+
+    ~FastForwardQueue() noexcept {
+        ::operator delete(slots_, std::align_val_t{CACHE_LINE_SIZE});
+    }
+
+    // Non-copyable, non-movable
+    FastForwardQueue(const FastForwardQueue&) = delete;
+    FastForwardQueue& operator=(const FastForwardQueue&) = delete;
+    FastForwardQueue(FastForwardQueue&&) = delete;
+    FastForwardQueue& operator=(FastForwardQueue&&) = delete;
+
+    /**
+     * @brief Try to enqueue a pointer (producer only)
+     * @param item Must not be nullptr
+     * @return true if successful, false if queue is full
+     */
+    bool try_push(T* item) noexcept {
+        std::atomic<T*>& slot = slots_[head_];
+        if (slot.load(std::memory_order_acquire) != nullptr) {
+            return false;  // Consumer has not freed this slot yet
+        }
+        slot.store(item, std::memory_order_release);
+        head_ = (head_ + 1) & mask_;
+        return true;
+    }
+
+    /**
+     * @brief Try to dequeue a pointer (consumer only)
+     * @return the pointer, or nullptr if queue is empty
+     */
+    T* try_pop() noexcept {
+        std::atomic<T*>& slot = slots_[tail_];
+        T* item = slot.load(std::memory_order_acquire);
+        if (item == nullptr) {
+            return nullptr;
+        }
+        slot.store(nullptr, std::memory_order_release);
+        tail_ = (tail_ + 1) & mask_;
+        return item;
+    }
+
+    /**
+     * @brief Temporal slipping (consumer only)
+     *
+     * If the producer is less than DANGER slots ahead, spin until it is GOOD
+     * slots ahead or max_spins run out. Call at the start of a batch.
+     */
+    void slip(size_t max_spins = 4096) noexcept {
+        if (distance() >= DANGER) {
+            return;
+        }
+        for (size_t i = 0; i < max_spins; ++i) {
+            cpu_relax();
+            if ((i & 63) == 63 && distance() >= GOOD) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Check if queue is empty (consumer only)
+     */
+    bool empty() const noexcept {
+        return slots_[tail_].load(std::memory_order_acquire) == nullptr;
+    }
+
+    /**
+     * @brief Get the capacity
+     */
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+};
+
+} // namespace lockfree
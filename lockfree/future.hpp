@@ -0,0 +1,373 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "mpmc_queue.hpp"
+
+namespace lockfree {
+
+template<typename T, size_t InlineSize> class Promise;
+template<typename T, size_t InlineSize> class Future;
+
+namespace detail {
+
+struct FutureUnit {};
+
+} // namespace detail
+
+/**
+ * @brief One-shot result slot shared by a Promise and a Future
+ *
+ * Lives wherever the caller puts it: in the task, on the waiting thread's
+ * stack, or in a SharedStatePool. Nothing is allocated; the value, an
+ * optional exception and one continuation of up to InlineSize bytes are
+ * stored inline.
+ *
+ * Coordination is a single atomic state word. Completing costs one
+ * CAS, get() on a ready state one load; a waiter only sets WAITER
+ * and parks on the word (futex) when the value is not there yet, and only
+ * then does the completing side issue a wake-up. It holds NOTIFYING across
+ * that wake-up and the waiter does not return until it is cleared, so the
+ * state is never reset or destroyed under the completing thread.
+ *
+ * Reusable after reset() once both sides are done with it.
+ */
+template<typename T, size_t InlineSize = 48>
+class SharedState {
+private:
+    friend class Promise<T, InlineSize>;
+    friend class Future<T, InlineSize>;
+
+    using Value = std::conditional_t<std::is_void_v<T>, detail::FutureUnit, T>;
+
+    static constexpr uint32_t READY = 1;   // Value or exception stored
+    static constexpr uint32_t WAITER = 2;  // A thread is parked in wait()
+    static constexpr uint32_t CONT = 4;    // Continuation installed
+    static constexpr uint32_t ERROR = 8;   // Completed with an exception
+    static constexpr uint32_t NOTIFYING = 16;  // Completer still waking the waiter
+
+    std::atomic<uint32_t> state_{0};
+    alignas(Value) std::byte value_[sizeof(Value)];
+    std::exception_ptr error_;
+
+    alignas(std::max_align_t) std::byte cont_[InlineSize];
+    void (*run_cont_)(SharedState&) = nullptr;
+
+    Value* value_ptr() noexcept {
+        return std::launder(reinterpret_cast<Value*>(value_));
+    }
+
+    void complete(uint32_t bits) {
+        // One CAS; NOTIFYING is only taken when a waiter is parked
+        uint32_t old = state_.load(std::memory_order_relaxed);
+        uint32_t desired;
+        do {
+            assert(!(old & READY) && "SharedState completed twice");
+            desired = old | READY | bits | ((old & WAITER) ? NOTIFYING : 0);
+        } while (!state_.compare_exchange_weak(old, desired, std::memory_order_acq_rel,
+                                               std::memory_order_relaxed));
+        if (old & CONT) {
+            run_cont_(*this);
+        } else if (old & WAITER) {
+            state_.notify_all();
+            // Last touch: the waiter may reset or destroy the state after this
+            state_.fetch_and(~NOTIFYING, std::memory_order_release);
+        }
+    }
+
+    template<typename... Args>
+    void set_value(Args&&... args) {
+        ::new (static_cast<void*>(value_)) Value(std::forward<Args>(args)...);
+        complete(0);
+    }
+
+    void set_exception(std::exception_ptr e) {
+        error_ = std::move(e);
+        complete(ERROR);
+    }
+
+    void wait() noexcept {
+        uint32_t s = state_.load(std::memory_order_acquire);
+        if (s & READY) {
+            return;
+        }
+        s = state_.fetch_or(WAITER, std::memory_order_acq_rel) | WAITER;
+        while (!(s & READY)) {
+            state_.wait(s, std::memory_order_acquire);
+            s = state_.load(std::memory_order_acquire);
+        }
+        // The completer is between its CAS and its last store, a short window
+        while (s & NOTIFYING) {
+            std::this_thread::yield();
+            s = state_.load(std::memory_order_acquire);
+        }
+    }
+
+    // After wait(); consumes the value
+    T take() {
+        if (state_.load(std::memory_order_relaxed) & ERROR) {
+            std::rethrow_exception(error_);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*value_ptr());
+        }
+    }
+
+    template<typename F>
+    void set_continuation(F&& f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= InlineSize, "continuation does not fit the inline buffer, raise InlineSize");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "over-aligned continuation");
+
+        ::new (static_cast<void*>(cont_)) Fn(std::forward<F>(f));
+        run_cont_ = [](SharedState& s) {
+            // Move out first: the continuation may release the state for reuse
+            Fn* stored = std::launder(reinterpret_cast<Fn*>(s.cont_));
+            Fn fn(std::move(*stored));
+            stored->~Fn();
+            fn(Future<T, InlineSize>(s));
+        };
+
+        uint32_t old = state_.fetch_or(CONT, std::memory_order_acq_rel);
+        if (old & READY) {
+            run_cont_(*this);
+        }
+    }
+
+public:
+    SharedState() = default;
+
+    ~SharedState() {
+        reset();
+    }
+
+    // Non-copyable, non-movable
+    SharedState(const SharedState&) = delete;
+    SharedState& operator=(const SharedState&) = delete;
+    SharedState(SharedState&&) = delete;
+    SharedState& operator=(SharedState&&) = delete;
+
+    /**
+     * @brief Destroy the stored result and make the state reusable
+     *
+     * Only once get() returned or the continuation ran.
+     */
+    void reset() noexcept {
+        uint32_t s = state_.load(std::memory_order_acquire);
+        if ((s & READY) && !(s & ERROR)) {
+            value_ptr()->~Value();
+        }
+        error_ = nullptr;
+        state_.store(0, std::memory_order_relaxed);
+    }
+
+    bool ready() const noexcept {
+        return state_.load(std::memory_order_acquire) & READY;
+    }
+};
+
+/**
+ * @brief Producing side of a SharedState (movable handle, does not own it)
+ *
+ * Destroying a Promise that was never satisfied stores
+ * std::future_errc::broken_promise so the waiter does not hang.
+ */
+template<typename T, size_t InlineSize = 48>
+class Promise {
+private:
+    SharedState<T, InlineSize>* state_;
+
+public:
+    explicit Promise(SharedState<T, InlineSize>& state) noexcept : state_(&state) {}
+
+    Promise(Promise&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+
+    Promise& operator=(Promise&& other) noexcept {
+        if (this != &other) {
+            abandon();
+            state_ = std::exchange(other.state_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Promise() {
+        abandon();
+    }
+
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    /**
+     * @brief Store the result and wake the waiter or run the continuation
+     */
+    template<typename... Args>
+    void set_value(Args&&... args) {
+        assert(state_ && "Promise already satisfied");
+        std::exchange(state_, nullptr)->set_value(std::forward<Args>(args)...);
+    }
+
+    void set_exception(std::exception_ptr e) {
+        assert(state_ && "Promise already satisfied");
+        std::exchange(state_, nullptr)->set_exception(std::move(e));
+    }
+
+    bool valid() const noexcept {
+        return state_ != nullptr;
+    }
+
+private:
+    void abandon() {
+        if (state_) {
+            set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+};
+
+/**
+ * @brief Consuming side of a SharedState (movable handle, does not own it)
+ */
+template<typename T, size_t InlineSize = 48>
+class Future {
+private:
+    SharedState<T, InlineSize>* state_;
+
+public:
+    explicit Future(SharedState<T, InlineSize>& state) noexcept : state_(&state) {}
+
+    Future(Future&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+
+    Future& operator=(Future&& other) noexcept {
+        state_ = std::exchange(other.state_, nullptr);
+        return *this;
+    }
+
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    bool valid() const noexcept {
+        return state_ != nullptr;
+    }
+
+    bool ready() const noexcept {
+        return state_->ready();
+    }
+
+    /**
+     * @brief Block until the result is stored (spurious-wakeup safe futex wait)
+     */
+    void wait() const noexcept {
+        state_->wait();
+    }
+
+    /**
+     * @brief Wait for and take the result, rethrowing a stored exception
+     *
+     * Invalidates the Future.
+     */
+    T get() {
+        SharedState<T, InlineSize>* s = std::exchange(state_, nullptr);
+        s->wait();
+        return s->take();
+    }
+
+    /**
+     * @brief Run f(Future<T>) with the ready Future once the result is stored
+     *
+     * Runs on the completing thread, or right here if already complete.
+     * f must fit in InlineSize bytes. Invalidates the Future.
+     */
+    template<typename F>
+    void then(F&& f) {
+        std::exchange(state_, nullptr)->set_continuation(std::forward<F>(f));
+    }
+
+    /**
+     * @brief Chain f(Future<T>) -> R into next, without allocating
+     *
+     * Exceptions thrown by f, or rethrown from get(), complete next.
+     * @return Future for next
+     */
+    template<typename R, size_t N, typename F>
+    Future<R, N> then(SharedState<R, N>& next, F&& f) {
+        then([p = Promise<R, N>(next), fn = std::decay_t<F>(std::forward<F>(f))](Future ready) mutable {
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    fn(std::move(ready));
+                    p.set_value();
+                } else {
+                    p.set_value(fn(std::move(ready)));
+                }
+            } catch (...) {
+                p.set_exception(std::current_exception());
+            }
+        });
+        return Future<R, N>(next);
+    }
+};
+
+/**
+ * @brief Fixed set of preallocated SharedStates for fire-and-forget use
+ *
+ * acquire() and release() are one MPMCQueue operation each. Release a
+ * state after get() returned, or from its continuation.
+ */
+template<typename T, size_t InlineSize = 48>
+class SharedStatePool {
+private:
+    using State = SharedState<T, InlineSize>;
+
+    std::unique_ptr<State[]> states_;
+    MPMCQueue<State*> free_;
+    const size_t size_;
+
+public:
+    explicit SharedStatePool(size_t size)
+        : states_(new State[size])
+        , free_(size < 2 ? 2 : size)  // MPMCQueue needs capacity >= 2
+        , size_(size)
+    {
+        for (size_t i = 0; i < size; ++i) {
+            free_.try_enqueue(&states_[i]);
+        }
+    }
+
+    // Non-copyable, non-movable
+    SharedStatePool(const SharedStatePool&) = delete;
+    SharedStatePool& operator=(const SharedStatePool&) = delete;
+    SharedStatePool(SharedStatePool&&) = delete;
+    SharedStatePool& operator=(SharedStatePool&&) = delete;
+
+    /**
+     * @brief Take a clean state
+     * @return nullptr if every state is in use
+     */
+    State* acquire() noexcept {
+        State* s = nullptr;
+        free_.try_dequeue(s);
+        return s;
+    }
+
+    /**
+     * @brief Reset a state and return it to the pool
+     */
+    void release(State* s) noexcept {
+        s->reset();
+        free_.try_enqueue(s);
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+};
+
+} // namespace lockfree
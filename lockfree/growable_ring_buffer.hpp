@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <cstddef>
+#include <utility>
+
+#include "epoch.hpp"
+#include "spsc_ring_buffer.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief SPSC ring that starts small and grows by linking larger rings
+ *
+ * When the producer finds its ring full, it allocates a ring twice the
+ * size (up to max_capacity), writes into it and links it behind the old
+ * one. The consumer finishes the old ring, then follows the link, so FIFO
+ * order is kept and neither side ever waits for the other.
+ *
+ * In steady state both sides work on a single Lockfree::RingBuffer, with
+ * one extra pointer load per operation. Drained rings are retired through
+ * EpochReclaimer, so size() callers on other threads, which walk the chain
+ * inside an epoch guard, never see a ring freed under them. They are freed
+ * as soon as no such walk is in progress.
+ */
+template<typename T>
+class GrowableRingBuffer {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Segment {
+        Lockfree::RingBuffer<T> ring;
+        std::atomic<Segment*> next{nullptr};
+
+        explicit Segment(size_t capacity) : ring(capacity) {}
+    };
+
+    const size_t max_capacity_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<Segment*> head_;  // Written by consumer only
+
+    // Producer private
+    alignas(CACHE_LINE_SIZE) Segment* tail_;
+
+    /**
+     * @brief Link a ring twice the size and make it the producer's (producer only)
+     * @return false if already at max_capacity
+     */
+    bool grow() {
+        const size_t current = tail_->ring.capacity();
+        if (current >= max_capacity_) {
+            return false;
+        }
+        Segment* next = new Segment(current * 2 > max_capacity_ ? max_capacity_ : current * 2);
+        tail_->next.store(next, std::memory_order_release);
+        tail_ = next;
+        return true;
+    }
+
+    /**
+     * @brief Move to the next ring once the current one is drained (consumer only)
+     * @return false if there is no next ring
+     */
+    bool advance(Segment* head) {
+        Segment* next = head->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        // The link was published after the producer's last write to head
+        if (!head->ring.empty()) {
+            return true;
+        }
+
+        head_.store(next, std::memory_order_release);
+        // Rings are large and retired only a handful of times, too rarely
+        // for the domain's periodic advance; free the old one right away
+        // unless a size() walk still holds it
+        EpochReclaimer::retire(head);
+        EpochReclaimer::reclaim();
+        return true;
+    }
+
+public:
+    /**
+     * @brief Construct ring buffer
+     * @param initial_capacity Capacity of the first ring (rounded up to a power of 2)
+     * @param max_capacity Largest ring the buffer may grow to
+     */
+    GrowableRingBuffer(size_t initial_capacity, size_t max_capacity)
+        : max_capacity_(max_capacity)
+    {
+        Segment* first = new Segment(initial_capacity);
+        head_.store(first, std::memory_order_relaxed);
+        tail_ = first;
+    }
+
+    ~GrowableRingBuffer() {
+        Segment* seg = head_.load(std::memory_order_relaxed);
+        while (seg) {
+            Segment* next = seg->next.load(std::memory_order_relaxed);
+            delete seg;
+            seg = next;
+        }
+    }
+
+    // Non-copyable, non-movable
+    GrowableRingBuffer(const GrowableRingBuffer&) = delete;
+    GrowableRingBuffer& operator=(const GrowableRingBuffer&) = delete;
+    GrowableRingBuffer(GrowableRingBuffer&&) = delete;
+    GrowableRingBuffer& operator=(GrowableRingBuffer&&) = delete;
+
+    /**
+     * @brief Try to write an item, growing if the ring is full (producer only)
+     * @return true if successful, false if full at max_capacity
+     */
+    template<typename U>
+    bool try_write(U&& item) {
+        if (tail_->ring.try_write(std::forward<U>(item))) {
+            return true;
+        }
+        if (!tail_->ring.full() || !grow()) {
+            return false;
+        }
+        return tail_->ring.try_write(std::forward<U>(item));
+    }
+
+    /**
+     * @brief Try to read an item (consumer only)
+     * @return true if successful, false if empty
+     */
+    bool try_read(T& out) {
+        Segment* head = head_.load(std::memory_order_relaxed);
+        while (!head->ring.try_read(out)) {
+            if (!advance(head)) {
+                return false;
+            }
+            head = head_.load(std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Try to read an item (consumer only)
+     * @return std::optional containing the item if successful, std::nullopt if empty
+     */
+    std::optional<T> try_read() {
+        Segment* head = head_.load(std::memory_order_relaxed);
+        while (true) {
+            if (auto item = head->ring.try_read()) {
+                return item;
+            }
+            if (!advance(head)) {
+                return std::nullopt;
+            }
+            head = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Get approximate size across all linked rings
+     *
+     * Safe from any thread: the walk runs inside an epoch guard.
+     */
+    size_t size() const {
+        EpochReclaimer::Guard guard;
+        size_t n = 0;
+        for (Segment* seg = head_.load(std::memory_order_acquire); seg;
+             seg = seg->next.load(std::memory_order_acquire)) {
+            n += seg->ring.size();
+        }
+        return n;
+    }
+
+    /**
+     * @brief Get the capacity of the ring the producer is currently filling (producer only)
+     */
+    size_t capacity() const noexcept {
+        return tail_->ring.capacity();
+    }
+
+    size_t max_capacity() const noexcept {
+        return max_capacity_;
+    }
+};
+
+} // namespace lockfree
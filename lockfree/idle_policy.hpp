@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "event_count.hpp"
+#include "locks.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief Spin-then-park idle policy for pool workers
+ *
+ * An idle worker spins for a while before parking, but at most
+ * max_spinners workers spin at once; the rest park on an EventCount right
+ * away. The spin budget follows an EWMA of how long idle workers recently
+ * waited for work: if items tend to arrive within the spin window,
+ * spinning catches them in microseconds, otherwise it shrinks to
+ * min_spin so idle cores stay idle.
+ *
+ * A spinner that finds work hands its role on by waking one parked worker,
+ * which becomes the next spinner. Producers only pay for a wake-up when
+ * nobody is spinning.
+ *
+ * Worker:
+ *   idle.wait([&] { return queue.try_dequeue(item) || stopping; });
+ *
+ * Producer:
+ *   queue.try_enqueue(item); idle.notify();
+ */
+class AdaptiveIdlePolicy {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr uint32_t CLOCK_CHECK_INTERVAL = 64;  // Spins between clock reads
+    static constexpr uint32_t YIELD_INTERVAL = 1024;      // Let producers run on oversubscribed cores
+    static constexpr int EWMA_SHIFT = 3;                  // Weight 1/8 for each new sample
+
+    using Clock = std::chrono::steady_clock;
+
+    EventCount parked_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> spinners_{0};
+
+    // Only written by workers coming out of idle, read by the same
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> avg_wait_ns_;
+
+    const uint32_t max_spinners_;
+    const int64_t min_spin_ns_;
+    const int64_t max_spin_ns_;
+
+    bool try_become_spinner() noexcept {
+        uint32_t n = spinners_.load(std::memory_order_relaxed);
+        while (n < max_spinners_) {
+            if (spinners_.compare_exchange_weak(n, n + 1, std::memory_order_seq_cst,
+                                                std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void record_wait(Clock::time_point start) noexcept {
+        int64_t waited = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        // Racy read-modify-write is fine, the average only needs to be roughly right
+        int64_t avg = avg_wait_ns_.load(std::memory_order_relaxed);
+        avg_wait_ns_.store(avg + ((waited - avg) >> EWMA_SHIFT), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Spin on try_get until the budget runs out (spinner only)
+     */
+    template<typename TryGet>
+    bool spin(TryGet& try_get, Clock::time_point start) {
+        const Clock::time_point deadline = start + std::chrono::nanoseconds(spin_budget_ns());
+        for (uint32_t i = 1;; ++i) {
+            if (try_get()) {
+                return true;
+            }
+            if (i % CLOCK_CHECK_INTERVAL == 0 && Clock::now() >= deadline) {
+                return false;
+            }
+            if (i % YIELD_INTERVAL == 0) {
+                std::this_thread::yield();
+            } else {
+                Concurrent::cpu_relax();
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Construct idle policy
+     * @param max_spinners Workers allowed to spin at the same time (at least 1)
+     * @param min_spin Spin budget when work arrives rarely
+     * @param max_spin Upper bound on the spin budget
+     */
+    explicit AdaptiveIdlePolicy(uint32_t max_spinners = 1,
+                                std::chrono::nanoseconds min_spin = std::chrono::microseconds(2),
+                                std::chrono::nanoseconds max_spin = std::chrono::microseconds(100))
+        : avg_wait_ns_(max_spin.count() / 2)
+        , max_spinners_(std::max<uint32_t>(max_spinners, 1))
+        , min_spin_ns_(min_spin.count())
+        , max_spin_ns_(std::max(max_spin.count(), min_spin.count()))
+    {}
+
+    // Non-copyable, non-movable
+    AdaptiveIdlePolicy(const AdaptiveIdlePolicy&) = delete;
+    AdaptiveIdlePolicy& operator=(const AdaptiveIdlePolicy&) = delete;
+    AdaptiveIdlePolicy(AdaptiveIdlePolicy&&) = delete;
+    AdaptiveIdlePolicy& operator=(AdaptiveIdlePolicy&&) = delete;
+
+    /**
+     * @brief Idle until try_get() succeeds
+     * @param try_get Attempts to take work; return true also to stop waiting
+     *                (e.g. on shutdown, paired with notify_all())
+     */
+    template<typename TryGet>
+    void wait(TryGet&& try_get) {
+        if (try_get()) {
+            return;
+        }
+        const Clock::time_point start = Clock::now();
+        while (true) {
+            if (try_become_spinner()) {
+                bool got = spin(try_get, start);
+                // Pairs with the fence in notify(): either the producer sees
+                // one spinner fewer and wakes a parked worker, or we see its item below
+                spinners_.fetch_sub(1, std::memory_order_seq_cst);
+                if (got) {
+                    // Hand the spinning role to a parked worker
+                    parked_.notify_one();
+                    record_wait(start);
+                    return;
+                }
+            }
+
+            uint32_t key = parked_.prepare_wait();
+            if (try_get()) {
+                parked_.cancel_wait();
+                record_wait(start);
+                return;
+            }
+            parked_.wait(key);
+        }
+    }
+
+    /**
+     * @brief Call after making work available
+     *
+     * Wakes a parked worker only if nobody is spinning.
+     */
+    void notify() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (spinners_.load(std::memory_order_relaxed) == 0) {
+            parked_.notify_one();
+        }
+    }
+
+    /**
+     * @brief Wake every parked worker, e.g. for shutdown
+     */
+    void notify_all() noexcept {
+        parked_.notify_all();
+    }
+
+    /**
+     * @brief Current spin budget derived from recent idle waits
+     */
+    int64_t spin_budget_ns() const noexcept {
+        int64_t budget = 2 * avg_wait_ns_.load(std::memory_order_relaxed);
+        // Waits longer than the cap end up parking anyway, so keep spins short
+        return budget > max_spin_ns_ ? min_spin_ns_ : std::max(budget, min_spin_ns_);
+    }
+
+    uint32_t spinners() const noexcept {
+        return spinners_.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace lockfree
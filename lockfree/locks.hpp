@@ -0,0 +1,350 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Lock policies for Concurrent::Queue
+ *
+ * All locks satisfy the standard Lockable requirements (lock, try_lock,
+ * unlock), so they work with std::lock_guard, std::scoped_lock and
+ * std::condition_variable_any.
+ */
+namespace Concurrent {
+
+/**
+ * @brief Spin-wait hint for the CPU (PAUSE on x86)
+ */
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+namespace detail {
+
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Back-off for queued spinlock waiters
+ *
+ * Spins with cpu_relax() first, then yields so a preempted lock holder can
+ * run when threads outnumber cores.
+ */
+class SpinWait {
+private:
+    static constexpr uint32_t YIELD_THRESHOLD = 1024;
+    uint32_t count_{0};
+
+public:
+    void once() noexcept {
+        if (count_ < YIELD_THRESHOLD) {
+            ++count_;
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+/**
+ * @brief Per-thread free list of queue nodes for MCS/CLH locks
+ *
+ * Nodes are only allocated while a thread's working set grows (e.g. holding
+ * two queues' locks in swap), after that lock/unlock never allocates.
+ */
+template<typename Node>
+class NodeCache {
+private:
+    std::vector<Node*> free_;
+
+public:
+    ~NodeCache() {
+        for (Node* node : free_) {
+            delete node;
+        }
+    }
+
+    Node* acquire() {
+        if (free_.empty()) {
+            return new Node();
+        }
+        Node* node = free_.back();
+        free_.pop_back();
+        return node;
+    }
+
+    void release(Node* node) {
+        free_.push_back(node);
+    }
+
+    static NodeCache& local() {
+        thread_local NodeCache cache;
+        return cache;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Ticket lock
+ *
+ * FIFO fair. All waiters spin on the same now_serving_ line, with back-off
+ * proportional to their distance from the head of the line.
+ */
+class TicketLock {
+private:
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<uint32_t> next_ticket_{0};
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<uint32_t> now_serving_{0};
+
+public:
+    TicketLock() = default;
+    TicketLock(const TicketLock&) = delete;
+    TicketLock& operator=(const TicketLock&) = delete;
+
+    void lock() noexcept {
+        const uint32_t ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+        detail::SpinWait spin;
+        while (true) {
+            uint32_t serving = now_serving_.load(std::memory_order_acquire);
+            if (serving == ticket) {
+                return;
+            }
+            // Proportional back-off: the further back in line, the longer we wait
+            for (uint32_t i = 0; i < (ticket - serving); ++i) {
+                spin.once();
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        uint32_t serving = now_serving_.load(std::memory_order_acquire);
+        uint32_t expected = serving;
+        return next_ticket_.compare_exchange_strong(
+            expected, serving + 1,
+            std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        // Only the owner writes now_serving_, so a plain increment is enough
+        now_serving_.store(now_serving_.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_release);
+    }
+};
+
+/**
+ * @brief MCS queue lock (Mellor-Crummey & Scott)
+ *
+ * Each waiter spins on the locked flag of its own node, so a release only
+ * touches the successor's cache line.
+ */
+class MCSLock {
+private:
+    struct alignas(detail::CACHE_LINE_SIZE) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> locked{false};
+    };
+
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<Node*> tail_{nullptr};
+    Node* owner_{nullptr};  // Only accessed by the lock holder
+
+public:
+    MCSLock() = default;
+    MCSLock(const MCSLock&) = delete;
+    MCSLock& operator=(const MCSLock&) = delete;
+
+    void lock() {
+        Node* node = detail::NodeCache<Node>::local().acquire();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->locked.store(true, std::memory_order_relaxed);
+
+        Node* pred = tail_.exchange(node, std::memory_order_acq_rel);
+        if (pred) {
+            pred->next.store(node, std::memory_order_release);
+            detail::SpinWait spin;
+            while (node->locked.load(std::memory_order_acquire)) {
+                spin.once();
+            }
+        }
+        owner_ = node;
+    }
+
+    bool try_lock() {
+        Node* node = detail::NodeCache<Node>::local().acquire();
+        node->next.store(nullptr, std::memory_order_relaxed);
+
+        Node* expected = nullptr;
+        if (!tail_.compare_exchange_strong(expected, node,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed)) {
+            detail::NodeCache<Node>::local().release(node);
+            return false;
+        }
+        owner_ = node;
+        return true;
+    }
+
+    void unlock() {
+        Node* node = owner_;
+        Node* next = node->next.load(std::memory_order_acquire);
+
+        if (!next) {
+            // No known successor, try to swing tail back to empty
+            Node* expected = node;
+            if (tail_.compare_exchange_strong(expected, nullptr,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                detail::NodeCache<Node>::local().release(node);
+                return;
+            }
+            // A successor is linking itself in, wait for it
+            detail::SpinWait spin;
+            while (!(next = node->next.load(std::memory_order_acquire))) {
+                spin.once();
+            }
+        }
+
+        next->locked.store(false, std::memory_order_release);
+        detail::NodeCache<Node>::local().release(node);
+    }
+};
+
+/**
+ * @brief CLH queue lock (Craig, Landin & Hagersten)
+ *
+ * Each waiter spins on its predecessor's node. On release the owner keeps
+ * the predecessor's node for reuse, so nodes migrate between threads.
+ */
+class CLHLock {
+private:
+    struct alignas(detail::CACHE_LINE_SIZE) Node {
+        std::atomic<bool> locked{false};
+    };
+
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<Node*> tail_;
+    Node* owner_{nullptr};  // Only accessed by the lock holder
+    Node* owner_pred_{nullptr};
+
+public:
+    CLHLock() : tail_(new Node()) {}
+
+    ~CLHLock() {
+        delete tail_.load(std::memory_order_relaxed);
+    }
+
+    CLHLock(const CLHLock&) = delete;
+    CLHLock& operator=(const CLHLock&) = delete;
+
+    void lock() {
+        Node* node = detail::NodeCache<Node>::local().acquire();
+        node->locked.store(true, std::memory_order_relaxed);
+
+        Node* pred = tail_.exchange(node, std::memory_order_acq_rel);
+        detail::SpinWait spin;
+        while (pred->locked.load(std::memory_order_acquire)) {
+            spin.once();
+        }
+        owner_ = node;
+        owner_pred_ = pred;
+    }
+
+    bool try_lock() {
+        Node* pred = tail_.load(std::memory_order_acquire);
+        if (pred->locked.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        Node* node = detail::NodeCache<Node>::local().acquire();
+        node->locked.store(true, std::memory_order_relaxed);
+        if (!tail_.compare_exchange_strong(pred, node,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed)) {
+            detail::NodeCache<Node>::local().release(node);
+            return false;
+        }
+        owner_ = node;
+        owner_pred_ = pred;
+        return true;
+    }
+
+    void unlock() {
+        Node* node = owner_;
+        Node* pred = owner_pred_;
+        node->locked.store(false, std::memory_order_release);
+        // Nobody spins on pred anymore, it becomes ours
+        detail::NodeCache<Node>::local().release(pred);
+    }
+};
+
+/**
+ * @brief Spin-then-park lock
+ *
+ * Spins briefly for short critical sections, then parks on a futex
+ * (std::atomic::wait). State: 0 unlocked, 1 locked, 2 locked with waiters.
+ */
+class HybridLock {
+private:
+    static constexpr uint32_t UNLOCKED = 0;
+    static constexpr uint32_t LOCKED = 1;
+    static constexpr uint32_t CONTENDED = 2;
+    static constexpr int SPIN_LIMIT = 128;
+
+    alignas(detail::CACHE_LINE_SIZE) std::atomic<uint32_t> state_{UNLOCKED};
+
+public:
+    HybridLock() = default;
+    HybridLock(const HybridLock&) = delete;
+    HybridLock& operator=(const HybridLock&) = delete;
+
+    void lock() noexcept {
+        uint32_t expected = UNLOCKED;
+        if (state_.compare_exchange_strong(expected, LOCKED,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+            return;
+        }
+
+        for (int i = 0; i < SPIN_LIMIT; ++i) {
+            cpu_relax();
+            if (state_.load(std::memory_order_relaxed) == UNLOCKED) {
+                expected = UNLOCKED;
+                if (state_.compare_exchange_weak(expected, LOCKED,
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+        }
+
+        // Slow path: mark contended and park until released
+        while (state_.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED) {
+            state_.wait(CONTENDED, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_lock() noexcept {
+        uint32_t expected = UNLOCKED;
+        return state_.compare_exchange_strong(expected, LOCKED,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        if (state_.exchange(UNLOCKED, std::memory_order_release) == CONTENDED) {
+            state_.notify_one();
+        }
+    }
+};
+
+} // namespace Concurrent
@@ -0,0 +1,579 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "epoch.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief One sampled reading of a registered queue or gauge
+ */
+struct MetricSample {
+    std::string name;
+    bool is_queue{true};     // false for a plain gauge, only value is set
+    uint64_t size{0};
+    uint64_t capacity{0};    // 0 if unbounded
+    uint64_t enqueued{0};    // Lifetime total (widened to 64 bits), 0 if the queue does not count
+    double enqueue_rate{0};  // Items per second since the previous sample
+    double value{0};
+};
+
+/**
+ * @brief Immutable result of one sampling pass
+ */
+struct MetricsSnapshot {
+    int64_t timestamp_ms{0};  // System clock
+    std::vector<MetricSample> samples;
+};
+
+namespace detail {
+
+template<typename Q, typename = void>
+struct has_index_type : std::false_type {};
+template<typename Q>
+struct has_index_type<Q, std::void_t<typename Q::index_type>> : std::true_type {};
+
+/**
+ * @brief Mask of the range a queue's position counter wraps in
+ */
+template<typename Q>
+constexpr uint64_t counter_mask() noexcept {
+    if constexpr (has_index_type<Q>::value) {
+        constexpr int bits = std::numeric_limits<typename Q::index_type>::digits;
+        if constexpr (bits < 64) {
+            return (uint64_t{1} << bits) - 1;
+        }
+    }
+    return ~uint64_t{0};
+}
+
+/**
+ * @brief Widens a wrapping counter to a monotonic 64-bit total
+ *
+ * Each reading adds the distance from the previous one, modulo the
+ * counter's range. A wrap is only seen if the counter is read at least once
+ * per wrap period (65536 items for a uint16_t Index).
+ */
+class WrappingCounter {
+private:
+    uint64_t last_raw_{0};
+    uint64_t total_{0};
+
+public:
+    uint64_t widen(uint64_t raw, uint64_t mask) noexcept {
+        total_ += (raw - last_raw_) & mask;
+        last_raw_ = raw;
+        return total_;
+    }
+};
+
+template<typename Q, typename = void>
+struct has_size_approx : std::false_type {};
+template<typename Q>
+struct has_size_approx<Q, std::void_t<decltype(std::declval<const Q&>().size_approx())>>
+    : std::true_type {};
+
+template<typename Q, typename = void>
+struct has_capacity : std::false_type {};
+template<typename Q>
+struct has_capacity<Q, std::void_t<decltype(std::declval<const Q&>().capacity())>>
+    : std::true_type {};
+
+template<typename Q, typename = void>
+struct has_enqueued_total : std::false_type {};
+template<typename Q>
+struct has_enqueued_total<Q, std::void_t<decltype(std::declval<const Q&>().enqueued_total())>>
+    : std::true_type {};
+
+template<typename Q, typename = void>
+struct has_written_total : std::false_type {};
+template<typename Q>
+struct has_written_total<Q, std::void_t<decltype(std::declval<const Q&>().written_total())>>
+    : std::true_type {};
+
+template<typename Q, typename = void>
+struct has_pushed_total : std::false_type {};
+template<typename Q>
+struct has_pushed_total<Q, std::void_t<decltype(std::declval<const Q&>().pushed_total())>>
+    : std::true_type {};
+
+/**
+ * @brief Read a queue's depth and counters using only loads
+ *
+ * Lock-based queues are read through size_approx() so that sampling
+ * never takes (and so never writes) their lock. The enqueue counter is
+ * widened through counter, which keeps its state between samples.
+ */
+template<typename Q>
+void read_queue(const Q& q, WrappingCounter& counter, MetricSample& out) {
+    if constexpr (has_size_approx<Q>::value) {
+        out.size = q.size_approx();
+    } else {
+        out.size = q.size();
+    }
+    if constexpr (has_capacity<Q>::value) {
+        out.capacity = q.capacity();
+    }
+    uint64_t raw = 0;
+    if constexpr (has_enqueued_total<Q>::value) {
+        raw = q.enqueued_total();
+    } else if constexpr (has_written_total<Q>::value) {
+        raw = q.written_total();
+    } else if constexpr (has_pushed_total<Q>::value) {
+        raw = q.pushed_total();
+    }
+    out.enqueued = counter.widen(raw, counter_mask<Q>());
+}
+
+} // namespace detail
+
+/**
+ * @brief Registry of named queues and gauges to export
+ *
+ * Queues of any type with size() (or size_approx()) register through
+ * add(), which returns an RAII handle; the queue must outlive it.
+ * Sampling holds the registry mutex, so once the handle is destroyed the
+ * sampler no longer touches the queue. The mutex is only taken by
+ * registration and by the sampler, never by queue operations.
+ */
+class MetricsRegistry {
+private:
+    struct Entry {
+        uint64_t id;
+        std::string name;
+        bool is_queue;
+        std::function<void(MetricSample&)> read;
+    };
+
+    std::mutex mtx_;
+    std::vector<Entry> entries_;
+    uint64_t next_id_{1};
+
+    void remove(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (entries_[i].id == id) {
+                entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(i));
+                return;
+            }
+        }
+    }
+
+    uint64_t insert(std::string name, bool is_queue, std::function<void(MetricSample&)> read) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        uint64_t id = next_id_++;
+        entries_.push_back(Entry{id, std::move(name), is_queue, std::move(read)});
+        return id;
+    }
+
+public:
+    /**
+     * @brief Keeps a registration alive; unregisters on destruction
+     */
+    class Registration {
+    private:
+        friend class MetricsRegistry;
+
+        MetricsRegistry* registry_{nullptr};
+        uint64_t id_{0};
+
+        Registration(MetricsRegistry* registry, uint64_t id) : registry_(registry), id_(id) {}
+
+    public:
+        Registration() = default;
+
+        Registration(Registration&& other) noexcept
+            : registry_(std::exchange(other.registry_, nullptr))
+            , id_(other.id_)
+        {}
+
+        Registration& operator=(Registration&& other) noexcept {
+            if (this != &other) {
+                reset();
+                registry_ = std::exchange(other.registry_, nullptr);
+                id_ = other.id_;
+            }
+            return *this;
+        }
+
+        ~Registration() {
+            reset();
+        }
+
+        void reset() {
+            if (registry_) {
+                registry_->remove(id_);
+                registry_ = nullptr;
+            }
+        }
+    };
+
+    MetricsRegistry() = default;
+
+    // Non-copyable, non-movable
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+    MetricsRegistry(MetricsRegistry&&) = delete;
+    MetricsRegistry& operator=(MetricsRegistry&&) = delete;
+
+    /**
+     * @brief Register a queue (RingBuffer, MPMCQueue, Concurrent::Queue, ...)
+     */
+    template<typename Q>
+    [[nodiscard]] Registration add(std::string name, const Q& queue) {
+        const Q* q = &queue;
+        // Reads run under mtx_, so the counter state needs no synchronization
+        return Registration(this, insert(std::move(name), true,
+                                         [q, counter = detail::WrappingCounter{}](MetricSample& out) mutable {
+                                             detail::read_queue(*q, counter, out);
+                                         }));
+    }
+
+    /**
+     * @brief Register a free-form gauge, e.g. CoDelQueue::dropped()
+     */
+    [[nodiscard]] Registration add_gauge(std::string name, std::function<double()> read) {
+        return Registration(this, insert(std::move(name), false,
+                                         [fn = std::move(read)](MetricSample& out) { out.value = fn(); }));
+    }
+
+    /**
+     * @brief Read every registered source once
+     */
+    void sample(std::vector<MetricSample>& out) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        out.clear();
+        out.reserve(entries_.size());
+        for (const Entry& e : entries_) {
+            MetricSample s;
+            s.name = e.name;
+            s.is_queue = e.is_queue;
+            e.read(s);
+            out.push_back(std::move(s));
+        }
+    }
+
+    /**
+     * @brief Process-wide registry
+     */
+    static MetricsRegistry& global() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+};
+
+/**
+ * @brief Output format for MetricsExporter
+ */
+enum class MetricsFormat {
+    Prometheus,  // Text exposition format
+    Json
+};
+
+/**
+ * @brief Where MetricsExporter writes each snapshot
+ */
+struct MetricsSink {
+    enum class Kind { File, UnixSocket };
+
+    Kind kind;
+    std::string path;
+
+    /**
+     * @brief Replace the file at path each interval (write + rename)
+     */
+    static MetricsSink file(std::string path) {
+        return MetricsSink{Kind::File, std::move(path)};
+    }
+
+    /**
+     * @brief Connect to a listening unix stream socket and send each snapshot
+     */
+    static MetricsSink unix_socket(std::string path) {
+        return MetricsSink{Kind::UnixSocket, std::move(path)};
+    }
+};
+
+/**
+ * @brief Background sampler that exports registry snapshots
+ *
+ * Every interval the sampler reads the registry, derives enqueue rates,
+ * publishes the result as an immutable snapshot and writes it to the sink.
+ * latest() readers never block the sampler: snapshots are swapped through
+ * an atomic pointer and old ones are reclaimed through EpochDomain.
+ */
+class MetricsExporter {
+private:
+    MetricsRegistry& registry_;
+    const MetricsSink sink_;
+    const MetricsFormat format_;
+    const std::chrono::milliseconds interval_;
+
+    std::atomic<MetricsSnapshot*> latest_{nullptr};
+    std::atomic<uint64_t> write_errors_{0};
+
+    std::mutex stop_mtx_;
+    std::condition_variable stop_cv_;
+    bool stopping_{false};
+    std::thread thread_;
+
+    static void append_escaped(std::string& out, const std::string& s) {
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+    }
+
+    static void append_number(std::string& out, double v) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6g", v);
+        out += buf;
+    }
+
+    static void append_prometheus(std::string& out, const char* metric, const char* label,
+                                  const std::string& name, double v) {
+        out += metric;
+        out += '{';
+        out += label;
+        out += "=\"";
+        append_escaped(out, name);
+        out += "\"} ";
+        append_number(out, v);
+        out += '\n';
+    }
+
+    static std::string render_prometheus(const MetricsSnapshot& snap) {
+        std::string out;
+        out += "# TYPE lockfree_queue_size gauge\n";
+        for (const auto& s : snap.samples) {
+            if (s.is_queue) append_prometheus(out, "lockfree_queue_size", "queue", s.name, double(s.size));
+        }
+        out += "# TYPE lockfree_queue_capacity gauge\n";
+        for (const auto& s : snap.samples) {
+            if (s.is_queue) append_prometheus(out, "lockfree_queue_capacity", "queue", s.name, double(s.capacity));
+        }
+        out += "# TYPE lockfree_queue_enqueued_total counter\n";
+        for (const auto& s : snap.samples) {
+            if (s.is_queue) append_prometheus(out, "lockfree_queue_enqueued_total", "queue", s.name, double(s.enqueued));
+        }
+        out += "# TYPE lockfree_queue_enqueue_rate gauge\n";
+        for (const auto& s : snap.samples) {
+            if (s.is_queue) append_prometheus(out, "lockfree_queue_enqueue_rate", "queue", s.name, s.enqueue_rate);
+        }
+        out += "# TYPE lockfree_gauge gauge\n";
+        for (const auto& s : snap.samples) {
+            if (!s.is_queue) append_prometheus(out, "lockfree_gauge", "name", s.name, s.value);
+        }
+        return out;
+    }
+
+    static std::string render_json(const MetricsSnapshot& snap) {
+        std::string out = "{\"timestamp_ms\":";
+        out += std::to_string(snap.timestamp_ms);
+        out += ",\"queues\":[";
+        bool first = true;
+        for (const auto& s : snap.samples) {
+            if (!s.is_queue) continue;
+            out += first ? "" : ",";
+            first = false;
+            out += "{\"name\":\"";
+            append_escaped(out, s.name);
+            out += "\",\"size\":" + std::to_string(s.size);
+            out += ",\"capacity\":" + std::to_string(s.capacity);
+            out += ",\"enqueued_total\":" + std::to_string(s.enqueued);
+            out += ",\"enqueue_rate\":";
+            append_number(out, s.enqueue_rate);
+            out += '}';
+        }
+        out += "],\"gauges\":{";
+        first = true;
+        for (const auto& s : snap.samples) {
+            if (s.is_queue) continue;
+            out += first ? "\"" : ",\"";
+            first = false;
+            append_escaped(out, s.name);
+            out += "\":";
+            append_number(out, s.value);
+        }
+        out += "}}\n";
+        return out;
+    }
+
+    static bool send_all(int fd, const std::string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            // MSG_NOSIGNAL: a collector that hangs up must not raise SIGPIPE
+            ssize_t n = ::send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool write_file(const std::string& data) {
+        // Write aside and rename so readers never see a partial file
+        std::string tmp = sink_.path + ".tmp";
+        std::FILE* f = std::fopen(tmp.c_str(), "w");
+        if (!f) {
+            return false;
+        }
+        bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+        ok = (std::fclose(f) == 0) && ok;
+        return ok && std::rename(tmp.c_str(), sink_.path.c_str()) == 0;
+    }
+
+    bool write_socket(const std::string& data) {
+        sockaddr_un addr{};
+        if (sink_.path.size() >= sizeof(addr.sun_path)) {
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        sink_.path.copy(addr.sun_path, sink_.path.size());
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+                  send_all(fd, data);
+        ::close(fd);
+        return ok;
+    }
+
+    void publish(MetricsSnapshot* snap) {
+        MetricsSnapshot* old = latest_.exchange(snap, std::memory_order_acq_rel);
+        if (old) {
+            EpochReclaimer::retire(old);
+        }
+    }
+
+    void run() {
+        std::vector<MetricSample> previous;
+        auto previous_time = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(stop_mtx_);
+        while (!stopping_) {
+            lock.unlock();
+
+            auto snap = std::make_unique<MetricsSnapshot>();
+            registry_.sample(snap->samples);
+            auto now = std::chrono::steady_clock::now();
+            snap->timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+            // Rates from the previous pass, matched by name; counter resets read as 0
+            double secs = std::chrono::duration<double>(now - previous_time).count();
+            for (auto& s : snap->samples) {
+                for (const auto& p : previous) {
+                    if (p.name == s.name && s.enqueued >= p.enqueued && secs > 0) {
+                        s.enqueue_rate = double(s.enqueued - p.enqueued) / secs;
+                        break;
+                    }
+                }
+            }
+            previous = snap->samples;
+            previous_time = now;
+
+            std::string text = format_ == MetricsFormat::Prometheus ? render_prometheus(*snap)
+                                                                    : render_json(*snap);
+            bool ok = sink_.kind == MetricsSink::Kind::File ? write_file(text) : write_socket(text);
+            if (!ok) {
+                write_errors_.fetch_add(1, std::memory_order_relaxed);
+            }
+            publish(snap.release());
+
+            lock.lock();
+            stop_cv_.wait_for(lock, interval_, [this] { return stopping_; });
+        }
+    }
+
+public:
+    /**
+     * @brief Start the sampler thread
+     * @param registry Sources to sample
+     * @param sink File or unix socket to write to
+     * @param format Prometheus text or JSON
+     * @param interval Time between samples
+     */
+    MetricsExporter(MetricsRegistry& registry, MetricsSink sink,
+                    MetricsFormat format = MetricsFormat::Prometheus,
+                    std::chrono::milliseconds interval = std::chrono::seconds(1))
+        : registry_(registry)
+        , sink_(std::move(sink))
+        , format_(format)
+        , interval_(interval)
+    {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~MetricsExporter() {
+        stop();
+        delete latest_.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    // Non-copyable, non-movable
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    MetricsExporter(MetricsExporter&&) = delete;
+    MetricsExporter& operator=(MetricsExporter&&) = delete;
+
+    /**
+     * @brief Stop and join the sampler thread
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(stop_mtx_);
+            stopping_ = true;
+        }
+        stop_cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * @brief Copy of the most recent snapshot (any thread, never blocks the sampler)
+     */
+    MetricsSnapshot latest() const {
+        EpochReclaimer::Guard guard;
+        const MetricsSnapshot* snap = latest_.load(std::memory_order_acquire);
+        return snap ? *snap : MetricsSnapshot{};
+    }
+
+    /**
+     * @brief Number of snapshots that could not be written to the sink
+     */
+    uint64_t write_errors() const noexcept {
+        return write_errors_.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace lockfree
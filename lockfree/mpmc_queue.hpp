@@ -3,10 +3,23 @@
 #include <atomic>
 #include <memory>
 #include <optional>
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <new>
 #include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "fast_mod.hpp"
 
 namespace lockfree {
 
@@ -14,16 +27,28 @@ namespace lockfree {
  * @brief Multi-Producer Multi-Consumer bounded lock-free queue
  * 
  * Based on Dmitry Vyukov's MPMC algorithm.
- * Capacity MUST be a power of 2.
+ * Capacity is rounded up to a power of 2 and slots are found by masking.
+ * For an exact, arbitrary capacity use Slot = FastMod (ExactMPMCQueue),
+ * which keeps the requested capacity with either constructor; the policy
+ * is a template parameter so the default queue carries no fastmod branch.
+ * 
+ * Index is the type of positions and per-slot sequence numbers. A narrow
+ * index (e.g. uint32_t) packs small elements tighter; positions wrap
+ * around and are compared by signed difference, so capacity is limited
+ * to below half the index range and must be a power of 2.
  * 
  * I will try to use it in a threadpool implementation
  */
-template<typename T>
+template<typename T, typename Index = size_t, typename Slot = PowerOf2Mod>
 class MPMCQueue {
 private:
+    static_assert(std::is_unsigned_v<Index>, "Index must be an unsigned integer type");
+
+    using Diff = std::make_signed_t<Index>;
+
     struct Node {
         alignas(T) std::byte storage[sizeof(T)];
-        std::atomic<size_t> sequence;
+        std::atomic<Index> sequence;
         
         T* data_ptr() noexcept { 
             return reinterpret_cast<T*>(storage); 
@@ -35,6 +60,8 @@ private:
     };
 
     static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t MIN_NODES_PER_INIT_THREAD = 64 * 1024;
     
     // Ensure capacity is power of 2
     static size_t next_power_of_2(size_t n) {
@@ -49,31 +76,122 @@ private:
         return n + 1;
     }
     
+    // Capacity the Slot policy can address for a requested size
+    static size_t slot_capacity(size_t capacity) {
+        if constexpr (std::is_same_v<Slot, PowerOf2Mod>) {
+            return next_power_of_2(capacity);
+        } else {
+            return capacity;
+        }
+    }
+    
+    // Wraparound-safe a - b
+    static Diff distance(Index a, Index b) noexcept {
+        return static_cast<Diff>(static_cast<Index>(a - b));
+    }
+    
     // Queue state
-    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
-    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<Index> enqueue_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<Index> dequeue_pos_{0};
     alignas(CACHE_LINE_SIZE) const size_t capacity_;
-    const size_t mask_;  // capacity_ - 1, for fast modulo
+    const Slot slot_;  // Position to slot
     Node* buffer_{nullptr};
 
+    // Large buffers are huge-page aligned so they can be backed by huge pages
+    static size_t buffer_alignment(size_t bytes) noexcept {
+        return bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : alignof(Node);
+    }
+
+    void init_nodes(size_t begin, size_t end) noexcept {
+        for (size_t i = begin; i < end; ++i) {
+            new (&buffer_[i]) Node;  // Default-init, element storage is left untouched
+            buffer_[i].sequence.store(static_cast<Index>(i), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Fault in and initialize the nodes, split across up to threads workers
+     */
+    void init_buffer(unsigned threads) {
+        size_t workers = std::min<size_t>(threads, capacity_ / MIN_NODES_PER_INIT_THREAD);
+        if (workers <= 1) {
+            init_nodes(0, capacity_);
+            return;
+        }
+
+        const size_t chunk = (capacity_ + workers - 1) / workers;
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        for (size_t w = 1; w < workers; ++w) {
+            size_t begin = w * chunk;
+            size_t end = std::min(capacity_, begin + chunk);
+            try {
+                pool.emplace_back([this, begin, end] { init_nodes(begin, end); });
+            } catch (...) {
+                init_nodes(begin, end);  // Could not spawn, do it here
+            }
+        }
+        init_nodes(0, std::min(capacity_, chunk));
+        for (auto& t : pool) {
+            t.join();  // Joining publishes the relaxed sequence stores
+        }
+    }
+
 public:
+    using index_type = Index;
+
     /**
      * @brief Construct queue with given capacity
-     * @param capacity Desired capacity (will be rounded up to next power of 2)
+     * @param capacity Desired capacity (at least 2); rounded up to the next
+     *        power of 2 with PowerOf2Mod, kept as is with FastMod
+     * @param init_threads Threads used to initialize the slots, worth raising
+     *        for capacities in the millions
+     */
+    explicit MPMCQueue(size_t capacity, unsigned init_threads = 1) 
+        : MPMCQueue(slot_capacity(std::max<size_t>(capacity, 2)), exact_capacity, init_threads)
+    {}
+
+    /**
+     * @brief Construct queue with exactly the given capacity
+     * @throws std::invalid_argument if capacity is below 2 (a single slot
+     *         cannot tell full from free), or not a power of 2 with the
+     *         PowerOf2Mod policy or an Index narrower than 64 bits
+     *         (positions would wrap at a non-multiple of capacity)
      */
-    explicit MPMCQueue(size_t capacity) 
-        : capacity_(next_power_of_2(capacity))
-        , mask_(capacity_ - 1)
+    MPMCQueue(size_t capacity, exact_capacity_t, unsigned init_threads = 1)
+        : capacity_(capacity)
+        , slot_(capacity_)
     {
+        if (capacity_ < 2) {
+            throw std::invalid_argument("MPMCQueue capacity must be at least 2");
+        }
+        if constexpr (std::is_same_v<Slot, PowerOf2Mod>) {
+            if (!slot_.is_power_of_2()) {
+                throw std::invalid_argument("MPMCQueue capacity must be a power of 2, use FastMod slots");
+            }
+        }
+        if (sizeof(Index) < sizeof(uint64_t) && !slot_.is_power_of_2()) {
+            throw std::invalid_argument("MPMCQueue with a narrow Index needs a power-of-2 capacity");
+        }
+        // At half the range a stale position's distance would read as negative
+        if (capacity_ > (static_cast<size_t>(std::numeric_limits<Index>::max()) >> 1)) {
+            throw std::length_error("MPMCQueue capacity must be below half the Index range");
+        }
+        
         // Allocate memory for nodes
-        buffer_ = static_cast<Node*>(::operator new(sizeof(Node) * capacity_, 
-                                                    std::align_val_t{alignof(Node)}));
+        const size_t bytes = sizeof(Node) * capacity_;
+        buffer_ = static_cast<Node*>(::operator new(bytes, 
+                                                    std::align_val_t{buffer_alignment(bytes)}));
         
-        // Initialize sequence numbers
-        for (size_t i = 0; i < capacity_; ++i) {
-            new (&buffer_[i]) Node();  // Placement new for Node
-            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // Ask for transparent huge pages before the first touch; best effort
+        if (bytes >= HUGE_PAGE_SIZE) {
+            madvise(buffer_, bytes & ~(HUGE_PAGE_SIZE - 1), MADV_HUGEPAGE);
         }
+#endif
+        
+        // Initialize sequence numbers
+        init_buffer(init_threads);
     }
 
     ~MPMCQueue() noexcept {
@@ -92,7 +210,7 @@ public:
         }
         
         // Free memory
-        ::operator delete(buffer_, std::align_val_t{alignof(Node)});
+        ::operator delete(buffer_, std::align_val_t{buffer_alignment(sizeof(Node) * capacity_)});
     }
 
     // Non-copyable, non-movable
@@ -116,18 +234,18 @@ public:
      */
     template<typename... Args>
     bool try_emplace(Args&&... args) {
-        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Index pos = enqueue_pos_.load(std::memory_order_relaxed);
         Node* node;
         
         while (true) {
-            node = &buffer_[pos & mask_];
-            size_t seq = node->sequence.load(std::memory_order_acquire);
-            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            node = &buffer_[slot_(pos)];
+            Index seq = node->sequence.load(std::memory_order_acquire);
+            Diff diff = distance(seq, pos);
             
             if (diff == 0) {
                 // Slot is available, try to claim it
                 if (enqueue_pos_.compare_exchange_weak(
-                    pos, pos + 1, 
+                    pos, static_cast<Index>(pos + 1), 
                     std::memory_order_relaxed)) {
                     break;
                 }
@@ -147,12 +265,12 @@ public:
             // Construction failed, need to revert enqueue_pos?
             // This is complex - for now we'll leave slot unusable
             // Better approach: Use a sentinel value in sequence
-            node->sequence.store(pos + capacity_, std::memory_order_release);
+            node->sequence.store(static_cast<Index>(pos + capacity_), std::memory_order_release);
             throw;
         }
         
         // Mark item as ready for consumption
-        node->sequence.store(pos + 1, std::memory_order_release);
+        node->sequence.store(static_cast<Index>(pos + 1), std::memory_order_release);
         return true;
     }
 
@@ -161,18 +279,18 @@ public:
      * @return std::optional containing the item if successful, std::nullopt if empty
      */
     std::optional<T> try_dequeue() {
-        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Index pos = dequeue_pos_.load(std::memory_order_relaxed);
         Node* node;
         
         while (true) {
-            node = &buffer_[pos & mask_];
-            size_t seq = node->sequence.load(std::memory_order_acquire);
-            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            node = &buffer_[slot_(pos)];
+            Index seq = node->sequence.load(std::memory_order_acquire);
+            Diff diff = distance(seq, static_cast<Index>(pos + 1));
             
             if (diff == 0) {
                 // Item is available, try to claim it
                 if (dequeue_pos_.compare_exchange_weak(
-                    pos, pos + 1,
+                    pos, static_cast<Index>(pos + 1),
                     std::memory_order_relaxed)) {
                     break;
                 }
@@ -193,7 +311,7 @@ public:
         } catch (...) {
             // Move failed, but we've already claimed the slot
             // Mark slot as unusable (poisoned)
-            node->sequence.store(pos + capacity_, std::memory_order_release);
+            node->sequence.store(static_cast<Index>(pos + capacity_), std::memory_order_release);
             throw;
         }
         
@@ -202,7 +320,7 @@ public:
         
         // Mark slot as available for reuse
         // Adding capacity_ ensures sequence doesn't wrap to a lower value
-        node->sequence.store(pos + capacity_, std::memory_order_release);
+        node->sequence.store(static_cast<Index>(pos + capacity_), std::memory_order_release);
         
         return result;
     }
@@ -212,17 +330,17 @@ public:
      * @return true if successful, false if empty
      */
     bool try_dequeue(T& out) {
-        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Index pos = dequeue_pos_.load(std::memory_order_relaxed);
         Node* node;
         
         while (true) {
-            node = &buffer_[pos & mask_];
-            size_t seq = node->sequence.load(std::memory_order_acquire);
-            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            node = &buffer_[slot_(pos)];
+            Index seq = node->sequence.load(std::memory_order_acquire);
+            Diff diff = distance(seq, static_cast<Index>(pos + 1));
             
             if (diff == 0) {
                 if (dequeue_pos_.compare_exchange_weak(
-                    pos, pos + 1,
+                    pos, static_cast<Index>(pos + 1),
                     std::memory_order_relaxed)) {
                     break;
                 }
@@ -238,34 +356,85 @@ public:
         try {
             out = std::move(*item_ptr);
         } catch (...) {
-            node->sequence.store(pos + capacity_, std::memory_order_release);
+            node->sequence.store(static_cast<Index>(pos + capacity_), std::memory_order_release);
             throw;
         }
         
         item_ptr->~T();
-        node->sequence.store(pos + capacity_, std::memory_order_release);
+        node->sequence.store(static_cast<Index>(pos + capacity_), std::memory_order_release);
         return true;
     }
 
+    /**
+     * @brief Copy queued items without consuming them (any thread)
+     *
+     * Exact when producers and consumers are quiesced. Under concurrent
+     * access each slot is validated by its sequence before and after the
+     * copy, and slots that changed in between are skipped.
+     * @return number of entries written to out, oldest first
+     */
+    size_t snapshot(T* out, size_t max_count) const noexcept {
+        static_assert(std::is_trivially_copyable_v<T>,
+                     "snapshot() requires trivially copyable T");
+
+        Index deq = dequeue_pos_.load(std::memory_order_acquire);
+        Index enq = enqueue_pos_.load(std::memory_order_acquire);
+        Diff diff = distance(enq, deq);
+        if (diff <= 0) {
+            return 0;
+        }
+        size_t count = std::min({static_cast<size_t>(diff), max_count, capacity_});
+
+        size_t copied = 0;
+        for (size_t i = 0; i < count; ++i) {
+            Index pos = static_cast<Index>(deq + i);
+            const Node& node = buffer_[slot_(pos)];
+            Index full = static_cast<Index>(pos + 1);
+
+            if (node.sequence.load(std::memory_order_acquire) != full) {
+                continue;  // Not yet written, or already consumed
+            }
+            std::memcpy(static_cast<void*>(out + copied), node.data_ptr(), sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (node.sequence.load(std::memory_order_relaxed) != full) {
+                continue;
+            }
+            ++copied;
+        }
+        return copied;
+    }
+
     /**
      * @brief Check if queue is empty (approximate)
      */
     bool empty() const noexcept {
         // This is only approximate - queue could become non-empty immediately after
-        size_t deq = dequeue_pos_.load(std::memory_order_relaxed);
-        size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
-        return deq >= enq;
+        Index deq = dequeue_pos_.load(std::memory_order_relaxed);
+        Index enq = enqueue_pos_.load(std::memory_order_relaxed);
+        return distance(enq, deq) <= 0;
     }
 
     /**
      * @brief Get approximate size
      */
     size_t size() const noexcept {
-        size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
-        size_t deq = dequeue_pos_.load(std::memory_order_relaxed);
+        Index enq = enqueue_pos_.load(std::memory_order_relaxed);
+        Index deq = dequeue_pos_.load(std::memory_order_relaxed);
         
-        // Both positions are monotonically increasing, so difference is size
-        return enq - deq;
+        // Positions advance monotonically (modulo wraparound), so difference is size;
+        // a dequeue racing ahead of our enqueue_pos_ read reads as empty
+        Diff diff = distance(enq, deq);
+        return diff > 0 ? static_cast<size_t>(diff) : 0;
+    }
+
+    /**
+     * @brief Total number of items enqueued (modulo the Index range)
+     * 
+     * A plain load of enqueue_pos_, for throughput monitoring. It wraps
+     * with narrow Index types; MetricsRegistry widens it to 64 bits.
+     */
+    uint64_t enqueued_total() const noexcept {
+        return enqueue_pos_.load(std::memory_order_relaxed);
     }
 
     /**
@@ -300,4 +469,10 @@ private:
     }
 };
 
+/**
+ * @brief MPMCQueue of exactly the requested capacity (construct with exact_capacity)
+ */
+template<typename T, typename Index = size_t>
+using ExactMPMCQueue = MPMCQueue<T, Index, FastMod>;
+
 } // namespace lockfree
\ No newline at end of file
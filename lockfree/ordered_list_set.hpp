@@ -0,0 +1,236 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+#include "epoch.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief Lock-free sorted set as a Harris–Michael linked list
+ *
+ * Erase marks the low bit of the victim's next pointer (logical delete)
+ * before unlinking it, so an insert can never link behind a node that is
+ * being removed. Traversals unlink marked nodes they meet and hand them to
+ * the Reclaimer.
+ *
+ * contains() takes no locks and does not write shared memory. Operations
+ * are O(n); meant for small-to-medium sets, or as the bucket list of a
+ * hash table.
+ *
+ * Reclaimer is a policy with a Guard type and a static retire(Node*), see
+ * EpochReclaimer.
+ */
+template<typename Key, typename Compare = std::less<Key>, typename Reclaimer = EpochReclaimer>
+class OrderedListSet {
+private:
+    struct Node {
+        Key key;
+        std::atomic<uintptr_t> next{0};  // Low bit set: this node is logically deleted
+
+        explicit Node(const Key& k) : key(k) {}
+    };
+
+    static_assert(alignof(Node) >= 2, "OrderedListSet needs a free low pointer bit");
+
+    static constexpr uintptr_t MARK = 1;
+
+    std::atomic<uintptr_t> head_{0};
+    Compare comp_;
+
+    static Node* ptr(uintptr_t link) noexcept {
+        return reinterpret_cast<Node*>(link & ~MARK);
+    }
+
+    static bool marked(uintptr_t link) noexcept {
+        return (link & MARK) != 0;
+    }
+
+    static uintptr_t link(Node* node) noexcept {
+        return reinterpret_cast<uintptr_t>(node);
+    }
+
+    /**
+     * @brief Find the first node not less than key, unlinking marked nodes on the way
+     * @param prev Set to the link that points at curr
+     * @param curr Set to that node, or nullptr at the end of the list
+     * @return true if curr holds key
+     */
+    bool find(const Key& key, std::atomic<uintptr_t>*& prev, Node*& curr) {
+    retry:
+        prev = &head_;
+        uintptr_t curr_link = prev->load(std::memory_order_acquire);
+
+        while (true) {
+            curr = ptr(curr_link);
+            if (!curr) {
+                return false;
+            }
+
+            uintptr_t next = curr->next.load(std::memory_order_acquire);
+            if (marked(next)) {
+                // Fails if prev changed or was itself marked
+                if (!prev->compare_exchange_strong(curr_link, next & ~MARK,
+                                                   std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+                    goto retry;
+                }
+                Reclaimer::retire(curr);
+                curr_link = next & ~MARK;
+                continue;
+            }
+
+            if (!comp_(curr->key, key)) {
+                return !comp_(key, curr->key);
+            }
+            prev = &curr->next;
+            curr_link = next;
+        }
+    }
+
+public:
+    explicit OrderedListSet(const Compare& comp = Compare()) : comp_(comp) {}
+
+    /**
+     * @brief Destroy set (no concurrent access allowed)
+     */
+    ~OrderedListSet() {
+        Node* node = ptr(head_.load(std::memory_order_relaxed));
+        while (node) {
+            Node* next = ptr(node->next.load(std::memory_order_relaxed));
+            delete node;
+            node = next;
+        }
+    }
+
+    // Non-copyable, non-movable
+    OrderedListSet(const OrderedListSet&) = delete;
+    OrderedListSet& operator=(const OrderedListSet&) = delete;
+    OrderedListSet(OrderedListSet&&) = delete;
+    OrderedListSet& operator=(OrderedListSet&&) = delete;
+
+    /**
+     * @brief Insert key
+     * @return true if inserted, false if already present
+     */
+    bool insert(const Key& key) {
+        typename Reclaimer::Guard guard;
+        Node* node = nullptr;
+        std::atomic<uintptr_t>* prev;
+        Node* curr;
+
+        while (true) {
+            if (find(key, prev, curr)) {
+                delete node;
+                return false;
+            }
+            if (!node) {
+                node = new Node(key);
+            }
+            node->next.store(link(curr), std::memory_order_relaxed);
+
+            uintptr_t expected = link(curr);
+            if (prev->compare_exchange_strong(expected, link(node),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Erase key
+     * @return true if this call removed it, false if not present
+     */
+    bool erase(const Key& key) {
+        typename Reclaimer::Guard guard;
+        std::atomic<uintptr_t>* prev;
+        Node* curr;
+
+        while (true) {
+            if (!find(key, prev, curr)) {
+                return false;
+            }
+
+            uintptr_t next = curr->next.load(std::memory_order_acquire);
+            if (marked(next)) {
+                continue;  // Lost to a concurrent erase, let find() clean up
+            }
+            if (!curr->next.compare_exchange_strong(next, next | MARK,
+                                                    std::memory_order_acq_rel,
+                                                    std::memory_order_relaxed)) {
+                continue;
+            }
+
+            // Logically deleted; unlink here or leave it to the next traversal
+            uintptr_t expected = link(curr);
+            if (prev->compare_exchange_strong(expected, next,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+                Reclaimer::retire(curr);
+            } else {
+                find(key, prev, curr);
+            }
+            return true;
+        }
+    }
+
+    /**
+     * @brief Check membership (read-only traversal)
+     */
+    bool contains(const Key& key) const {
+        typename Reclaimer::Guard guard;
+        Node* curr = ptr(head_.load(std::memory_order_acquire));
+        while (curr && comp_(curr->key, key)) {
+            curr = ptr(curr->next.load(std::memory_order_acquire));
+        }
+        return curr && !comp_(key, curr->key) &&
+               !marked(curr->next.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Visit every key in order (approximate under concurrent updates)
+     */
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        typename Reclaimer::Guard guard;
+        Node* curr = ptr(head_.load(std::memory_order_acquire));
+        while (curr) {
+            uintptr_t next = curr->next.load(std::memory_order_acquire);
+            if (!marked(next)) {
+                fn(curr->key);
+            }
+            curr = ptr(next);
+        }
+    }
+
+    /**
+     * @brief Check if set is empty (approximate)
+     */
+    bool empty() const {
+        typename Reclaimer::Guard guard;
+        Node* curr = ptr(head_.load(std::memory_order_acquire));
+        while (curr) {
+            uintptr_t next = curr->next.load(std::memory_order_acquire);
+            if (!marked(next)) {
+                return false;
+            }
+            curr = ptr(next);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Count keys (approximate, O(n))
+     */
+    size_t size() const {
+        size_t n = 0;
+        for_each([&](const Key&) { ++n; });
+        return n;
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "mpmc_queue.hpp"
+
+namespace lockfree {
+
+/**
+ * @brief Key-affinity partitioned queue: FIFO per key, parallel across keys
+ *
+ * Keys hash to one of V virtual partitions, and a route table maps each
+ * virtual partition to one of P shards. Each shard is a multi-producer
+ * ring drained by exactly one consumer, so items with the same key come
+ * out in the order they went in, while different shards run in parallel.
+ *
+ * Rebalancing moves a virtual partition to another shard. To keep per-key
+ * order, the partition is paused (pushes to it fail) until everything
+ * already routed to the old shard has been consumed, then re-routed.
+ */
+template<typename Key, typename T, typename Hash = std::hash<Key>>
+class PartitionedQueue {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr uint32_t PAUSED = 1u << 31;
+
+    struct Entry {
+        uint32_t vpart;
+        T value;
+
+        template<typename U>
+        Entry(uint32_t vp, U&& v) : vpart(vp), value(std::forward<U>(v)) {}
+    };
+
+    struct alignas(CACHE_LINE_SIZE) VPart {
+        std::atomic<uint32_t> route{0};  // Shard index, PAUSED while migrating
+        std::atomic<uint32_t> count{0};  // Items in flight or queued
+    };
+
+    std::vector<std::unique_ptr<MPMCQueue<Entry>>> shards_;
+    std::unique_ptr<VPart[]> vparts_;
+    const size_t num_vparts_;
+    Hash hash_;
+    std::mutex migrate_mtx_;  // Serializes migrations (control path only)
+
+public:
+    /**
+     * @brief Construct queue
+     * @param shards Number of shards (one consumer each)
+     * @param shard_capacity Capacity of each shard (rounded up to next power of 2)
+     * @param vparts_per_shard Virtual partitions per shard, the unit of rebalancing
+     */
+    PartitionedQueue(size_t shards, size_t shard_capacity, size_t vparts_per_shard = 16,
+                     const Hash& hash = Hash())
+        : vparts_(new VPart[shards * vparts_per_shard])
+        , num_vparts_(shards * vparts_per_shard)
+        , hash_(hash)
+    {
+        shards_.reserve(shards);
+        for (size_t i = 0; i < shards; ++i) {
+            // Vyukov's queue needs at least two slots
+            shards_.emplace_back(new MPMCQueue<Entry>(shard_capacity < 2 ? 2 : shard_capacity));
+        }
+        for (size_t vp = 0; vp < num_vparts_; ++vp) {
+            vparts_[vp].route.store(static_cast<uint32_t>(vp % shards), std::memory_order_relaxed);
+        }
+    }
+
+    // Non-copyable, non-movable
+    PartitionedQueue(const PartitionedQueue&) = delete;
+    PartitionedQueue& operator=(const PartitionedQueue&) = delete;
+    PartitionedQueue(PartitionedQueue&&) = delete;
+    PartitionedQueue& operator=(PartitionedQueue&&) = delete;
+
+    /**
+     * @brief Attempt to enqueue an item under key (any thread)
+     * @return true if successful, false if the shard is full or the
+     *         key's partition is being migrated
+     */
+    template<typename U>
+    bool try_push(const Key& key, U&& item) {
+        const uint32_t vp = static_cast<uint32_t>(hash_(key) % num_vparts_);
+        VPart& part = vparts_[vp];
+
+        uint32_t route = part.route.load(std::memory_order_acquire);
+        if (route & PAUSED) {
+            return false;
+        }
+
+        // Pairs with migrate(): either we see the pause or it sees our count
+        part.count.fetch_add(1, std::memory_order_seq_cst);
+        if (part.route.load(std::memory_order_seq_cst) != route) {
+            part.count.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+
+        if (!shards_[route]->try_emplace(vp, std::forward<U>(item))) {
+            part.count.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Attempt to dequeue from a shard (that shard's consumer only)
+     * @return true if successful, false if the shard is empty
+     */
+    bool try_pop(size_t shard, T& out) {
+        auto entry = shards_[shard]->try_dequeue();
+        if (!entry) {
+            return false;
+        }
+        out = std::move(entry->value);
+        vparts_[entry->vpart].count.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move a virtual partition to another shard
+     *
+     * Blocks until items already queued for it are consumed, so the old
+     * shard's consumer must keep running. Pushes to the partition fail
+     * meanwhile.
+     */
+    void migrate(size_t vpart, size_t to_shard) {
+        std::lock_guard<std::mutex> lock(migrate_mtx_);
+        VPart& part = vparts_[vpart];
+
+        uint32_t route = part.route.load(std::memory_order_relaxed);
+        if (route == to_shard) {
+            return;
+        }
+
+        part.route.store(route | PAUSED, std::memory_order_seq_cst);
+        while (part.count.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+        part.route.store(static_cast<uint32_t>(to_shard), std::memory_order_release);
+    }
+
+    /**
+     * @brief Move idle partitions off the busiest shard onto the least busy one
+     *
+     * A hot key then shares its shard with less traffic. Only partitions
+     * with nothing queued are picked, so this rarely waits on a consumer.
+     * @return number of partitions moved
+     */
+    size_t rebalance(size_t max_moves = 1) {
+        size_t busiest = 0;
+        size_t idlest = 0;
+        for (size_t s = 1; s < shards_.size(); ++s) {
+            if (shards_[s]->size() > shards_[busiest]->size()) busiest = s;
+            if (shards_[s]->size() < shards_[idlest]->size()) idlest = s;
+        }
+        if (shards_[busiest]->size() <= shards_[idlest]->size() + 1) {
+            return 0;
+        }
+
+        size_t moved = 0;
+        for (size_t vp = 0; vp < num_vparts_ && moved < max_moves; ++vp) {
+            if (vparts_[vp].route.load(std::memory_order_relaxed) == busiest &&
+                vparts_[vp].count.load(std::memory_order_relaxed) == 0) {
+                migrate(vp, idlest);
+                ++moved;
+            }
+        }
+        return moved;
+    }
+
+    /**
+     * @brief Virtual partition a key hashes to
+     */
+    size_t partition_of(const Key& key) const {
+        return hash_(key) % num_vparts_;
+    }
+
+    /**
+     * @brief Shard a virtual partition currently routes to
+     */
+    size_t shard_of_partition(size_t vpart) const noexcept {
+        return vparts_[vpart].route.load(std::memory_order_acquire) & ~PAUSED;
+    }
+
+    /**
+     * @brief Approximate number of queued items for a virtual partition
+     */
+    size_t partition_load(size_t vpart) const noexcept {
+        return vparts_[vpart].count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get approximate number of items in a shard
+     */
+    size_t shard_size(size_t shard) const noexcept {
+        return shards_[shard]->size();
+    }
+
+    size_t shards() const noexcept {
+        return shards_.size();
+    }
+
+    size_t partitions() const noexcept {
+        return num_vparts_;
+    }
+};
+
+} // namespace lockfree
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <condition_variable>
@@ -12,10 +15,16 @@
 /**
  * @brief Thread-safe lock-based concurrent Queue
  * 
+ * The Lock parameter selects the lock policy: std::mutex (default) or one of
+ * the queued spinlocks from locks.hpp (TicketLock, MCSLock, CLHLock,
+ * HybridLock). Pick by benchmark for the workload at hand.
+ * 
+ * Blocked consumers are woken LIFO: the most recently parked one, whose
+ * cache is still warm, gets the next item, and surplus waiters stay asleep.
  */
 namespace Concurrent {
 
-template<typename T, class Allocator = std::allocator<T>>
+template<typename T, class Allocator = std::allocator<T>, class Lock = std::mutex>
 class Queue {
 private:
     struct Node {
@@ -31,10 +40,28 @@ private:
     
     Node* head;
     Node* tail;
-    std::size_t count;
     
-    mutable std::mutex mtx;
-    std::condition_variable cv;
+    // Written under mtx only; atomic so size_approx() can read it without the lock
+    std::atomic<std::size_t> count;
+    std::atomic<std::uint64_t> pushed{0};  // Total items ever pushed
+    
+    // std::condition_variable only works with std::mutex
+    using CondVar = std::conditional_t<std::is_same_v<Lock, std::mutex>,
+                                       std::condition_variable,
+                                       std::condition_variable_any>;
+    
+    // One per blocked consumer, on its stack; linked while parked
+    struct Waiter {
+        CondVar cv;
+        Waiter* prev = nullptr;
+        Waiter* next = nullptr;
+        bool signaled = false;
+    };
+    
+    mutable Lock mtx;
+    // MCSLock/CLHLock may allocate a queue node in lock()
+    static constexpr bool nothrow_lock = noexcept(std::declval<Lock&>().lock());
+    Waiter* waiters = nullptr;  // Top of the LIFO stack, guarded by mtx
     
     NodeAllocator alloc;
     
@@ -63,6 +90,94 @@ private:
         deallocate_node(node);
     }
     
+    std::size_t get_count() const noexcept {
+        return count.load(std::memory_order_relaxed);
+    }
+    
+    // Plain load + store, the lock already serializes writers
+    void set_count(std::size_t n) noexcept {
+        count.store(n, std::memory_order_relaxed);
+    }
+    
+    void note_pushed(std::size_t n) noexcept {
+        set_count(get_count() + n);
+        pushed.store(pushed.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    
+    // Caller holds mtx
+    void push_waiter(Waiter* w) noexcept {
+        w->next = waiters;
+        if (waiters) {
+            waiters->prev = w;
+        }
+        waiters = w;
+    }
+    
+    // Caller holds mtx; only needed for a waiter that timed out
+    void remove_waiter(Waiter* w) noexcept {
+        if (w->prev) {
+            w->prev->next = w->next;
+        } else {
+            waiters = w->next;
+        }
+        if (w->next) {
+            w->next->prev = w->prev;
+        }
+    }
+    
+    /**
+     * @brief Wake up to n waiters, most recently parked first
+     * 
+     * Caller holds mtx: a woken waiter can only return, and destroy its
+     * node, after reacquiring it.
+     */
+    void wake(std::size_t n) noexcept {
+        while (n-- > 0 && waiters) {
+            Waiter* w = waiters;
+            waiters = w->next;
+            if (waiters) {
+                waiters->prev = nullptr;
+            }
+            w->signaled = true;
+            w->cv.notify_one();
+        }
+    }
+    
+    /**
+     * @brief Block until the queue is non-empty (caller holds lock)
+     * @param wait Waits on a node's cv; returns false once the deadline passed
+     * @return false on timeout with the queue still empty
+     */
+    template<typename WaitFn>
+    bool wait_for_item(std::unique_lock<Lock>& lock, WaitFn wait) {
+        while (!head) {
+            Waiter w;
+            push_waiter(&w);
+            while (!w.signaled) {
+                if (!wait(w.cv, lock) && !w.signaled) {
+                    remove_waiter(&w);
+                    return head != nullptr;
+                }
+            }
+            // Signaled, but a try_pop may have taken the item first
+        }
+        return true;
+    }
+    
+    bool wait_for_item(std::unique_lock<Lock>& lock) {
+        return wait_for_item(lock, [](CondVar& cv, std::unique_lock<Lock>& l) {
+            cv.wait(l);
+            return true;
+        });
+    }
+    
+    template<typename Clock, typename Duration>
+    bool wait_for_item(std::unique_lock<Lock>& lock, const std::chrono::time_point<Clock, Duration>& deadline) {
+        return wait_for_item(lock, [&deadline](CondVar& cv, std::unique_lock<Lock>& l) {
+            return cv.wait_until(l, deadline) == std::cv_status::no_timeout;
+        });
+    }
+    
     void clear() noexcept {
         while (head) {
             Node* temp = head;
@@ -70,7 +185,7 @@ private:
             destroy_node(temp);
         }
         tail = nullptr;
-        count = 0;
+        set_count(0);
     }
 
 public:
@@ -98,11 +213,11 @@ public:
         std::lock_guard lock(other.mtx);
         head = other.head;
         tail = other.tail;
-        count = other.count;
+        set_count(other.get_count());
         
         other.head = nullptr;
         other.tail = nullptr;
-        other.count = 0;
+        other.set_count(0);
     }
     
     ~Queue() {
@@ -128,7 +243,7 @@ public:
                     tail->next = new_node;
                     tail = new_node;
                 }
-                ++count;
+                set_count(get_count() + 1);
                 current = current->next;
             }
         }
@@ -147,11 +262,11 @@ public:
                 alloc = std::move(other.alloc);
                 head = other.head;
                 tail = other.tail;
-                count = other.count;
+                set_count(other.get_count());
             } else if (alloc == other.alloc) {
                 head = other.head;
                 tail = other.tail;
-                count = other.count;
+                set_count(other.get_count());
             } else {
                 Node* current = other.head;
                 while (current) {
@@ -162,7 +277,7 @@ public:
                         tail->next = new_node;
                         tail = new_node;
                     }
-                    ++count;
+                    set_count(get_count() + 1);
                     current = current->next;
                 }
                 other.clear();
@@ -171,7 +286,7 @@ public:
             
             other.head = nullptr;
             other.tail = nullptr;
-            other.count = 0;
+            other.set_count(0);
         }
         return *this;
     }
@@ -210,14 +325,30 @@ public:
     }
     
     // Capacity
-    bool empty() const noexcept {
+    bool empty() const noexcept(nothrow_lock) {
         std::lock_guard lock(mtx);
-        return count == 0;
+        return get_count() == 0;
     }
     
-    std::size_t size() const noexcept {
+    std::size_t size() const noexcept(nothrow_lock) {
         std::lock_guard lock(mtx);
-        return count;
+        return get_count();
+    }
+    
+    /**
+     * @brief Size without taking the lock (may be momentarily stale)
+     * 
+     * Only loads, so monitoring does not contend with producers and consumers.
+     */
+    std::size_t size_approx() const noexcept {
+        return get_count();
+    }
+    
+    /**
+     * @brief Total number of items pushed over the queue's lifetime
+     */
+    std::uint64_t pushed_total() const noexcept {
+        return pushed.load(std::memory_order_relaxed);
     }
     
     // Modifiers
@@ -232,9 +363,9 @@ public:
                 tail->next = new_node;
                 tail = new_node;
             }
-            ++count;
+            note_pushed(1);
+            wake(1);
         }
-        cv.notify_one();
     }
     
     template<std::ranges::input_range Range>
@@ -266,9 +397,10 @@ public:
                 tail->next = first;
             }
             tail = last;
-            count += std::ranges::distance(range);
+            std::size_t n = std::ranges::distance(range);
+            note_pushed(n);
+            wake(n);
         }
-        cv.notify_all();
     }
     
     template<typename... Args>
@@ -282,22 +414,22 @@ public:
                 tail->next = new_node;
                 tail = new_node;
             }
-            ++count;
+            note_pushed(1);
+            wake(1);
         }
-        cv.notify_one();
         return tail->data;
     }
     
     void pop() {
         std::unique_lock lock(mtx);
-        cv.wait(lock, [this] { return head != nullptr; });
+        wait_for_item(lock);
         
         Node* temp = head;
         head = head->next;
         if (!head) {
             tail = nullptr;
         }
-        --count;
+        set_count(get_count() - 1);
         
         lock.unlock();
         destroy_node(temp);
@@ -315,7 +447,7 @@ public:
         if (!head) {
             tail = nullptr;
         }
-        --count;
+        set_count(get_count() - 1);
         
         destroy_node(temp);
         return true;
@@ -324,7 +456,7 @@ public:
     template<typename Rep, typename Period>
     bool pop_for(T& value, const std::chrono::duration<Rep, Period>& timeout) {
         std::unique_lock lock(mtx);
-        if (!cv.wait_for(lock, timeout, [this] { return head != nullptr; })) {
+        if (!wait_for_item(lock, std::chrono::steady_clock::now() + timeout)) {
             return false;
         }
         
@@ -334,7 +466,7 @@ public:
         if (!head) {
             tail = nullptr;
         }
-        --count;
+        set_count(get_count() - 1);
         
         lock.unlock();
         destroy_node(temp);
@@ -344,7 +476,7 @@ public:
     template<typename Clock, typename Duration>
     bool pop_until(T& value, const std::chrono::time_point<Clock, Duration>& timeout_time) {
         std::unique_lock lock(mtx);
-        if (!cv.wait_until(lock, timeout_time, [this] { return head != nullptr; })) {
+        if (!wait_for_item(lock, timeout_time)) {
             return false;
         }
         
@@ -354,7 +486,7 @@ public:
         if (!head) {
             tail = nullptr;
         }
-        --count;
+        set_count(get_count() - 1);
         
         lock.unlock();
         destroy_node(temp);
@@ -375,14 +507,16 @@ public:
             
             std::swap(head, other.head);
             std::swap(tail, other.tail);
-            std::swap(count, other.count);
+            std::size_t n = get_count();
+            set_count(other.get_count());
+            other.set_count(n);
         }
     }
     
     // Additional utility methods
     void wait_and_pop(T& value) {
         std::unique_lock lock(mtx);
-        cv.wait(lock, [this] { return head != nullptr; });
+        wait_for_item(lock);
         
         value = std::move(head->data);
         Node* temp = head;
@@ -390,7 +524,7 @@ public:
         if (!head) {
             tail = nullptr;
         }
-        --count;
+        set_count(get_count() - 1);
         
         lock.unlock();
         destroy_node(temp);
@@ -414,17 +548,13 @@ public:
             head = head->next;
             destroy_node(temp);
             ++popped;
-            --count;
+            set_count(get_count() - 1);
         }
         
         if (!head) {
             tail = nullptr;
         }
         
-        if (popped > 0) {
-            cv.notify_all();
-        }
-        
         return popped;
     }
     
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace lockfree {
+
+/**
+ * @brief Lock-free token-bucket rate limiter
+ *
+ * The whole bucket state is one atomic word: the virtual time (ns) at which
+ * the bucket runs dry (GCRA). Tokens available at time now are
+ * (now - tat) / interval, capped at the burst size. Acquiring n tokens moves
+ * tat forward by n * interval with a single CAS.
+ *
+ * Pair with TokenCache per producer thread to amortize the CAS over a batch.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class TokenBucket {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> tat_;
+    alignas(CACHE_LINE_SIZE) const int64_t interval_ns_;  // Time per token
+    const int64_t burst_ns_;                              // Time to refill the bucket
+
+    static int64_t now_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+    }
+
+public:
+    /**
+     * @brief Construct a full bucket
+     * @param rate Tokens per second (resolution is 1 ns per token)
+     * @param burst Bucket size, max tokens granted back to back
+     */
+    TokenBucket(double rate, size_t burst)
+        : interval_ns_(std::max<int64_t>(1, std::llround(1e9 / rate)))
+        , burst_ns_(interval_ns_ * static_cast<int64_t>(std::max<size_t>(burst, 1)))
+    {
+        tat_.store(now_ns() - burst_ns_, std::memory_order_relaxed);
+    }
+
+    // Non-copyable, non-movable
+    TokenBucket(const TokenBucket&) = delete;
+    TokenBucket& operator=(const TokenBucket&) = delete;
+
+    /**
+     * @brief Take up to n tokens
+     * @return number of tokens granted, 0 if the bucket is empty
+     */
+    size_t try_acquire_up_to(size_t n) noexcept {
+        const int64_t now = now_ns();
+        int64_t tat = tat_.load(std::memory_order_relaxed);
+
+        while (true) {
+            // Idle time beyond the burst does not accumulate tokens
+            int64_t base = std::max(tat, now - burst_ns_);
+            int64_t available = (now - base) / interval_ns_;
+            if (available <= 0) {
+                return 0;
+            }
+            int64_t granted = std::min<int64_t>(available, static_cast<int64_t>(n));
+            if (tat_.compare_exchange_weak(tat, base + granted * interval_ns_,
+                                           std::memory_order_relaxed)) {
+                return static_cast<size_t>(granted);
+            }
+        }
+    }
+
+    /**
+     * @brief Take exactly n tokens, all or nothing
+     * @return true if granted
+     */
+    bool try_acquire(size_t n = 1) noexcept {
+        const int64_t now = now_ns();
+        const int64_t cost = static_cast<int64_t>(n) * interval_ns_;
+        int64_t tat = tat_.load(std::memory_order_relaxed);
+
+        while (true) {
+            int64_t base = std::max(tat, now - burst_ns_);
+            if (base + cost > now) {
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, base + cost,
+                                           std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Give back unused tokens
+     */
+    void release(size_t n) noexcept {
+        tat_.fetch_sub(static_cast<int64_t>(n) * interval_ns_, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get approximate number of tokens available now
+     */
+    size_t available() const noexcept {
+        const int64_t now = now_ns();
+        int64_t base = std::max(tat_.load(std::memory_order_relaxed), now - burst_ns_);
+        return static_cast<size_t>(std::max<int64_t>(0, (now - base) / interval_ns_));
+    }
+
+    size_t burst() const noexcept {
+        return static_cast<size_t>(burst_ns_ / interval_ns_);
+    }
+};
+
+/**
+ * @brief Per-thread token cache in front of a TokenBucket
+ *
+ * Owned by one thread. Refills a batch of tokens with one CAS, so the
+ * common path is a local decrement. Unused tokens go back on destruction.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class TokenCache {
+private:
+    TokenBucket<Clock>& bucket_;
+    const size_t batch_;
+    size_t tokens_{0};
+
+public:
+    TokenCache(TokenBucket<Clock>& bucket, size_t batch)
+        : bucket_(bucket)
+        , batch_(std::max<size_t>(batch, 1))
+    {}
+
+    ~TokenCache() {
+        flush();
+    }
+
+    TokenCache(const TokenCache&) = delete;
+    TokenCache& operator=(const TokenCache&) = delete;
+
+    /**
+     * @brief Take one token
+     * @return true if granted
+     */
+    bool try_acquire() noexcept {
+        if (tokens_ == 0) {
+            tokens_ = bucket_.try_acquire_up_to(batch_);
+            if (tokens_ == 0) {
+                return false;
+            }
+        }
+        --tokens_;
+        return true;
+    }
+
+    /**
+     * @brief Return cached tokens to the shared bucket
+     */
+    void flush() noexcept {
+        if (tokens_ > 0) {
+            bucket_.release(tokens_);
+            tokens_ = 0;
+        }
+    }
+
+    size_t cached() const noexcept {
+        return tokens_;
+    }
+};
+
+} // namespace lockfree
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <new>
+
+namespace lockfree {
+
+/**
+ * @brief Lock-free reorder ring: many depositors, one in-order consumer
+ *
+ * Every item carries a sequence number. Workers deposit into slot
+ * seq & mask in any order; the consumer releases items strictly in
+ * sequence, stopping at the first gap.
+ *
+ * Each slot has a turn word: 2 * seq while it waits for seq, 2 * seq + 1
+ * once seq is in it. A deposit more than capacity ahead of the consumer
+ * finds the slot still owned by an older sequence and is refused, which
+ * bounds the window and gives backpressure.
+ *
+ * Sequence numbers start at 0 and must each be deposited exactly once.
+ */
+template<typename T>
+class ReorderBuffer {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Slot {
+        std::atomic<uint64_t> turn;
+        alignas(T) std::byte storage[sizeof(T)];
+
+        T* data_ptr() noexcept {
+            return reinterpret_cast<T*>(storage);
+        }
+    };
+
+    static size_t next_power_of_2(size_t n) {
+        if (n == 0) return 1;
+        --n;
+        n |= n >> 1;
+        n |= n >> 2;
+        n |= n >> 4;
+        n |= n >> 8;
+        n |= n >> 16;
+        n |= n >> 32;
+        return n + 1;
+    }
+
+    Slot* slots_;
+    const size_t capacity_;
+    const size_t mask_;
+
+    // Consumer private, published for window checks
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> next_{0};
+
+public:
+    /**
+     * @brief Construct buffer
+     * @param capacity Reorder window (rounded up to next power of 2)
+     */
+    explicit ReorderBuffer(size_t capacity)
+        : capacity_(next_power_of_2(capacity))
+        , mask_(capacity_ - 1)
+    {
+        slots_ = static_cast<Slot*>(::operator new(sizeof(Slot) * capacity_,
+                                                   std::align_val_t{alignof(Slot)}));
+        for (size_t i = 0; i < capacity_; ++i) {
+            new (&slots_[i]) Slot();
+            slots_[i].turn.store(2 * i, std::memory_order_relaxed);
+        }
+    }
+
+    ~ReorderBuffer() noexcept {
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i].turn.load(std::memory_order_relaxed) & 1) {
+                slots_[i].data_ptr()->~T();
+            }
+            slots_[i].~Slot();
+        }
+        ::operator delete(slots_, std::align_val_t{alignof(Slot)});
+    }
+
+    // Non-copyable, non-movable
+    ReorderBuffer(const ReorderBuffer&) = delete;
+    ReorderBuffer& operator=(const ReorderBuffer&) = delete;
+    ReorderBuffer(ReorderBuffer&&) = delete;
+    ReorderBuffer& operator=(ReorderBuffer&&) = delete;
+
+    /**
+     * @brief Attempt to deposit the item for seq (any thread)
+     * @return true if successful, false if seq is beyond the window
+     */
+    template<typename U>
+    bool try_deposit(uint64_t seq, U&& item) {
+        Slot& slot = slots_[seq & mask_];
+        if (slot.turn.load(std::memory_order_acquire) != 2 * seq) {
+            return false;
+        }
+        new (slot.data_ptr()) T(std::forward<U>(item));
+        slot.turn.store(2 * seq + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Deposit the item for seq, yielding while it is beyond the window
+     */
+    template<typename U>
+    void deposit(uint64_t seq, U&& item) {
+        Slot& slot = slots_[seq & mask_];
+        while (slot.turn.load(std::memory_order_acquire) != 2 * seq) {
+            std::this_thread::yield();
+        }
+        new (slot.data_ptr()) T(std::forward<U>(item));
+        slot.turn.store(2 * seq + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Attempt to take the next item in sequence (consumer only)
+     * @return true if successful, false if that sequence has not arrived yet
+     */
+    bool try_pop(T& out) {
+        const uint64_t seq = next_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[seq & mask_];
+        if (slot.turn.load(std::memory_order_acquire) != 2 * seq + 1) {
+            return false;
+        }
+
+        T* item = slot.data_ptr();
+        out = std::move(*item);
+        item->~T();
+
+        next_.store(seq + 1, std::memory_order_relaxed);
+        slot.turn.store(2 * (seq + capacity_), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Attempt to take the next item in sequence (consumer only)
+     * @return the item, or std::nullopt if that sequence has not arrived yet
+     */
+    std::optional<T> try_pop() {
+        const uint64_t seq = next_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[seq & mask_];
+        if (slot.turn.load(std::memory_order_acquire) != 2 * seq + 1) {
+            return std::nullopt;
+        }
+
+        T* item = slot.data_ptr();
+        std::optional<T> result(std::move(*item));
+        item->~T();
+
+        next_.store(seq + 1, std::memory_order_relaxed);
+        slot.turn.store(2 * (seq + capacity_), std::memory_order_release);
+        return result;
+    }
+
+    /**
+     * @brief Release the whole contiguous prefix to fn (consumer only)
+     * @return number of items released
+     */
+    template<typename Fn>
+    size_t drain(Fn&& fn) {
+        size_t n = 0;
+        while (auto item = try_pop()) {
+            fn(std::move(*item));
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Next sequence the consumer is waiting for (approximate off the consumer)
+     */
+    uint64_t next_sequence() const noexcept {
+        return next_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check whether seq currently falls inside the window (approximate)
+     */
+    bool in_window(uint64_t seq) const noexcept {
+        return seq - next_.load(std::memory_order_relaxed) < capacity_;
+    }
+
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+};
+
+} // namespace lockfree
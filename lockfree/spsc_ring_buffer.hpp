@@ -3,9 +3,16 @@
 #include <atomic>
 #include <optional>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <new>
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "fast_mod.hpp"
 
 namespace Lockfree {
 
@@ -13,11 +20,19 @@ namespace Lockfree {
  * @brief Lock-free ring buffer (SPSC)
  * 
  * Fixed-size circular buffer optimized for single producer, single consumer.
- * Uses power-of-2 capacity for optimal performance.
+ * Uses power-of-2 capacity for optimal performance. For exactly the
+ * requested capacity use Slot = lockfree::FastMod (ExactRingBuffer), which
+ * keeps the requested capacity with either constructor.
+ * 
+ * Index is the type of the read/write positions. Positions wrap around,
+ * so a narrow index (e.g. uint32_t) works for any number of operations
+ * as long as capacity is below half its range and a power of 2.
  */
-template<typename T>
+template<typename T, typename Index = size_t, typename Slot = lockfree::PowerOf2Mod>
 class RingBuffer {
 private:
+    static_assert(std::is_unsigned_v<Index>, "Index must be an unsigned integer type");
+
     static constexpr size_t CACHE_LINE_SIZE = 64;
     
     // Ensure capacity is power of 2 for fast modulo
@@ -33,40 +48,82 @@ private:
         return n + 1;
     }
     
+    // Capacity the Slot policy can address for a requested size
+    static constexpr size_t slot_capacity(size_t capacity) noexcept {
+        if constexpr (std::is_same_v<Slot, lockfree::PowerOf2Mod>) {
+            return next_power_of_2(capacity);
+        } else {
+            return capacity;
+        }
+    }
+    
     // Storage for elements
     alignas(alignof(T)) 
     std::byte* storage_;  // Raw storage for T objects
     
     size_t capacity_;
-    size_t mask_;  // capacity_ - 1 for fast modulo
+    Slot slot_;  // Position to slot
     
     // Producer cache line
     alignas(CACHE_LINE_SIZE) 
-    std::atomic<size_t> write_pos_{0};
-    size_t cached_read_pos_{0};  // Producer reads consumer's position
+    std::atomic<Index> write_pos_{0};
+    Index cached_read_pos_{0};  // Producer reads consumer's position
     
-    char padding1_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    char padding1_[CACHE_LINE_SIZE - sizeof(std::atomic<Index>) - sizeof(Index)];
     
     // Consumer cache line
     alignas(CACHE_LINE_SIZE) 
-    std::atomic<size_t> read_pos_{0};
-    size_t cached_write_pos_{0};  // Consumer reads producer's position
+    std::atomic<Index> read_pos_{0};
+    Index cached_write_pos_{0};  // Consumer reads producer's position
     
-    char padding2_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+    char padding2_[CACHE_LINE_SIZE - sizeof(std::atomic<Index>) - sizeof(Index)];
+
+    // Items between two positions, correct across wraparound
+    static size_t used(Index write, Index read) noexcept {
+        return static_cast<Index>(write - read);
+    }
 
 public:
+    using index_type = Index;
+
     /**
      * @brief Construct ring buffer with given capacity
-     * @param capacity Desired capacity (will be rounded up to next power of 2)
+     * @param capacity Desired capacity; rounded up to the next power of 2
+     *        with PowerOf2Mod, kept as is with FastMod
      */
     explicit RingBuffer(size_t capacity)
-        : capacity_(next_power_of_2(capacity))
-        , mask_(capacity_ - 1)
+        : RingBuffer(slot_capacity(capacity), lockfree::exact_capacity)
+    {}
+
+    /**
+     * @brief Construct ring buffer with exactly the given capacity
+     * @throws std::invalid_argument if capacity is 0, or not a power of 2
+     *         with the PowerOf2Mod policy or an Index narrower than 64 bits
+     */
+    RingBuffer(size_t capacity, lockfree::exact_capacity_t)
+        : capacity_(capacity)
+        , slot_(capacity_)
         , write_pos_(0)
         , cached_read_pos_(0)
         , read_pos_(0)
         , cached_write_pos_(0)
     {
+        if (capacity_ == 0) {
+            throw std::invalid_argument("RingBuffer capacity must be non-zero");
+        }
+        if constexpr (std::is_same_v<Slot, lockfree::PowerOf2Mod>) {
+            if (!slot_.is_power_of_2()) {
+                throw std::invalid_argument("RingBuffer capacity must be a power of 2, use FastMod slots");
+            }
+        }
+        if (sizeof(Index) < sizeof(uint64_t) && !slot_.is_power_of_2()) {
+            throw std::invalid_argument("RingBuffer with a narrow Index needs a power-of-2 capacity");
+        }
+        // At half the range a stale position's distance would read as negative
+        if (capacity_ > (static_cast<size_t>(std::numeric_limits<Index>::max()) >> 1)) {
+            throw std::length_error("RingBuffer capacity must be below half the Index range");
+        }
+        
         // Allocate raw storage for T objects
         storage_ = static_cast<std::byte*>(
             ::operator new(sizeof(T) * capacity_, std::align_val_t{alignof(T)})
@@ -76,11 +133,11 @@ public:
     ~RingBuffer() noexcept {
         // Destroy any remaining elements
         if constexpr (!std::is_trivially_destructible_v<T>) {
-            size_t read = read_pos_.load(std::memory_order_relaxed);
-            size_t write = write_pos_.load(std::memory_order_relaxed);
+            Index read = read_pos_.load(std::memory_order_relaxed);
+            Index write = write_pos_.load(std::memory_order_relaxed);
             
             while (read != write) {
-                T* ptr = reinterpret_cast<T*>(storage_ + ((read & mask_) * sizeof(T)));
+                T* ptr = reinterpret_cast<T*>(storage_ + (slot_(read) * sizeof(T)));
                 ptr->~T();
                 ++read;
             }
@@ -104,21 +161,21 @@ public:
         static_assert(std::is_constructible_v<T, U&&>,
                      "Cannot construct T from provided argument");
         
-        size_t write = write_pos_.load(std::memory_order_relaxed);
-        size_t read = cached_read_pos_;
+        Index write = write_pos_.load(std::memory_order_relaxed);
+        Index read = cached_read_pos_;
         
         // Check if full
-        if ((write - read) >= capacity_) {
+        if (used(write, read) >= capacity_) {
             // Refresh cache with acquire semantics
             read = read_pos_.load(std::memory_order_acquire);
             cached_read_pos_ = read;
-            if ((write - read) >= capacity_) {
+            if (used(write, read) >= capacity_) {
                 return false;  // Buffer is full
             }
         }
         
         // Construct element in-place
-        T* ptr = reinterpret_cast<T*>(storage_ + ((write & mask_) * sizeof(T)));
+        T* ptr = reinterpret_cast<T*>(storage_ + (slot_(write) * sizeof(T)));
         try {
             new (ptr) T(std::forward<U>(item));
         } catch (...) {
@@ -127,7 +184,7 @@ public:
         }
         
         // Publish write with release semantics
-        write_pos_.store(write + 1, std::memory_order_release);
+        write_pos_.store(static_cast<Index>(write + 1), std::memory_order_release);
         return true;
     }
 
@@ -140,25 +197,25 @@ public:
         static_assert(std::is_constructible_v<T, Args...>,
                      "Cannot construct T from provided arguments");
         
-        size_t write = write_pos_.load(std::memory_order_relaxed);
-        size_t read = cached_read_pos_;
+        Index write = write_pos_.load(std::memory_order_relaxed);
+        Index read = cached_read_pos_;
         
-        if ((write - read) >= capacity_) {
+        if (used(write, read) >= capacity_) {
             read = read_pos_.load(std::memory_order_acquire);
             cached_read_pos_ = read;
-            if ((write - read) >= capacity_) {
+            if (used(write, read) >= capacity_) {
                 return false;
             }
         }
         
-        T* ptr = reinterpret_cast<T*>(storage_ + ((write & mask_) * sizeof(T)));
+        T* ptr = reinterpret_cast<T*>(storage_ + (slot_(write) * sizeof(T)));
         try {
             new (ptr) T(std::forward<Args>(args)...);
         } catch (...) {
             return false;
         }
         
-        write_pos_.store(write + 1, std::memory_order_release);
+        write_pos_.store(static_cast<Index>(write + 1), std::memory_order_release);
         return true;
     }
 
@@ -167,21 +224,21 @@ public:
      * @return std::optional containing the item if successful, std::nullopt if empty
      */
     std::optional<T> try_read() noexcept(std::is_nothrow_move_constructible_v<T>) {
-        size_t read = read_pos_.load(std::memory_order_relaxed);
-        size_t write = cached_write_pos_;
+        Index read = read_pos_.load(std::memory_order_relaxed);
+        Index write = cached_write_pos_;
         
         // Check if empty
-        if (read >= write) {
+        if (read == write) {
             // Refresh cache with acquire semantics
             write = write_pos_.load(std::memory_order_acquire);
             cached_write_pos_ = write;
-            if (read >= write) {
+            if (read == write) {
                 return std::nullopt;  // Buffer is empty
             }
         }
         
         // Read element
-        T* ptr = reinterpret_cast<T*>(storage_ + ((read & mask_) * sizeof(T)));
+        T* ptr = reinterpret_cast<T*>(storage_ + (slot_(read) * sizeof(T)));
         
         // Move construct the result
         std::optional<T> result;
@@ -196,7 +253,7 @@ public:
         ptr->~T();
         
         // Publish read with release semantics
-        read_pos_.store(read + 1, std::memory_order_release);
+        read_pos_.store(static_cast<Index>(read + 1), std::memory_order_release);
         
         return result;
     }
@@ -206,18 +263,18 @@ public:
      * @return true if successful, false if empty
      */
     bool try_read(T& out) noexcept(std::is_nothrow_move_assignable_v<T>) {
-        size_t read = read_pos_.load(std::memory_order_relaxed);
-        size_t write = cached_write_pos_;
+        Index read = read_pos_.load(std::memory_order_relaxed);
+        Index write = cached_write_pos_;
         
-        if (read >= write) {
+        if (read == write) {
             write = write_pos_.load(std::memory_order_acquire);
             cached_write_pos_ = write;
-            if (read >= write) {
+            if (read == write) {
                 return false;
             }
         }
         
-        T* ptr = reinterpret_cast<T*>(storage_ + ((read & mask_) * sizeof(T)));
+        T* ptr = reinterpret_cast<T*>(storage_ + (slot_(read) * sizeof(T)));
         try {
             out = std::move(*ptr);
         } catch (...) {
@@ -225,7 +282,7 @@ public:
         }
         
         ptr->~T();
-        read_pos_.store(read + 1, std::memory_order_release);
+        read_pos_.store(static_cast<Index>(read + 1), std::memory_order_release);
         return true;
     }
 
@@ -233,32 +290,66 @@ public:
      * @brief Peek at front element without removing (consumer only)
      */
     const T* peek() const noexcept {
-        size_t read = read_pos_.load(std::memory_order_relaxed);
-        size_t write = write_pos_.load(std::memory_order_acquire);
+        Index read = read_pos_.load(std::memory_order_relaxed);
+        Index write = write_pos_.load(std::memory_order_acquire);
         
-        if (read >= write) {
+        if (read == write) {
             return nullptr;
         }
         
-        return reinterpret_cast<const T*>(storage_ + ((read & mask_) * sizeof(T)));
+        return reinterpret_cast<const T*>(storage_ + (slot_(read) * sizeof(T)));
+    }
+
+    /**
+     * @brief Copy the oldest items without consuming them (any thread)
+     * 
+     * Seqlock-style observer for monitoring: copies a window of slots, then
+     * re-reads read_pos_ and keeps only entries the consumer has not released
+     * in the meantime (a released slot may already be overwritten).
+     * Only loads are added, producer and consumer paths are unchanged.
+     * @return number of entries written to out, oldest first
+     */
+    size_t snapshot(T* out, size_t max_count) const noexcept {
+        static_assert(std::is_trivially_copyable_v<T>,
+                     "snapshot() requires trivially copyable T");
+        
+        Index read = read_pos_.load(std::memory_order_acquire);
+        Index write = write_pos_.load(std::memory_order_acquire);
+        size_t count = std::min({used(write, read), max_count, capacity_});
+        
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(static_cast<void*>(out + i),
+                        storage_ + (slot_(read + i) * sizeof(T)), sizeof(T));
+        }
+        
+        // Re-validate: positions below the new read_pos_ may have been reused
+        std::atomic_thread_fence(std::memory_order_acquire);
+        Index read_after = read_pos_.load(std::memory_order_relaxed);
+        if (read_after == read) {
+            return count;
+        }
+        
+        size_t stale = std::min(used(read_after, read), count);
+        std::memmove(static_cast<void*>(out), out + stale, (count - stale) * sizeof(T));
+        return count - stale;
     }
 
     /**
      * @brief Check if buffer is empty (consumer only)
      */
     bool empty() const noexcept {
-        size_t read = read_pos_.load(std::memory_order_relaxed);
-        size_t write = write_pos_.load(std::memory_order_acquire);
-        return read >= write;
+        Index read = read_pos_.load(std::memory_order_relaxed);
+        Index write = write_pos_.load(std::memory_order_acquire);
+        return read == write;
     }
 
     /**
      * @brief Check if buffer is full (producer only)
      */
     bool full() const noexcept {
-        size_t write = write_pos_.load(std::memory_order_relaxed);
-        size_t read = read_pos_.load(std::memory_order_acquire);
-        return (write - read) >= capacity_;
+        Index write = write_pos_.load(std::memory_order_relaxed);
+        Index read = read_pos_.load(std::memory_order_acquire);
+        return used(write, read) >= capacity_;
     }
 
     /**
@@ -266,9 +357,21 @@ public:
      * Note: This is approximate because producer/consumer may be concurrently modifying
      */
     size_t size() const noexcept {
-        size_t write = write_pos_.load(std::memory_order_acquire);
-        size_t read = read_pos_.load(std::memory_order_acquire);
-        return write - read;
+        Index write = write_pos_.load(std::memory_order_acquire);
+        Index read = read_pos_.load(std::memory_order_acquire);
+        // read_pos_ may have passed the write_pos_ we loaded; that reads as empty
+        size_t n = used(write, read);
+        return n <= capacity_ ? n : 0;
+    }
+
+    /**
+     * @brief Total number of items written (modulo the Index range)
+     * 
+     * A plain load of write_pos_, for throughput monitoring. It wraps
+     * with narrow Index types; MetricsRegistry widens it to 64 bits.
+     */
+    uint64_t written_total() const noexcept {
+        return write_pos_.load(std::memory_order_relaxed);
     }
 
     /**
@@ -291,11 +394,11 @@ public:
      */
     void clear() noexcept {
         if constexpr (!std::is_trivially_destructible_v<T>) {
-            size_t read = read_pos_.load(std::memory_order_relaxed);
-            size_t write = write_pos_.load(std::memory_order_relaxed);
+            Index read = read_pos_.load(std::memory_order_relaxed);
+            Index write = write_pos_.load(std::memory_order_relaxed);
             
             while (read != write) {
-                T* ptr = reinterpret_cast<T*>(storage_ + ((read & mask_) * sizeof(T)));
+                T* ptr = reinterpret_cast<T*>(storage_ + (slot_(read) * sizeof(T)));
                 ptr->~T();
                 ++read;
             }
@@ -308,4 +411,10 @@ public:
     }
 };
 
+/**
+ * @brief RingBuffer of exactly the requested capacity (construct with lockfree::exact_capacity)
+ */
+template<typename T, typename Index = size_t>
+using ExactRingBuffer = RingBuffer<T, Index, lockfree::FastMod>;
+
 } // namespace Lockfree
\ No newline at end of file
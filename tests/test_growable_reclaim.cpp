@@ -0,0 +1,142 @@
+// Drained rings of a GrowableRingBuffer must be freed while it is in use,
+// not only when the buffer or the process goes away. Live heap bytes are
+// tracked through replaced global operator new/delete.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#include <malloc.h>
+
+#include "lockfree/growable_ring_buffer.hpp"
+
+namespace {
+
+std::atomic<int64_t> live_bytes{0};
+
+void* track(void* p) {
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    live_bytes.fetch_add(int64_t(malloc_usable_size(p)), std::memory_order_relaxed);
+    return p;
+}
+
+void untrack(void* p) noexcept {
+    if (p) {
+        live_bytes.fetch_sub(int64_t(malloc_usable_size(p)), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+} // namespace
+
+void* operator new(size_t n) {
+    return track(std::malloc(n ? n : 1));
+}
+
+void* operator new(size_t n, std::align_val_t al) {
+    size_t a = static_cast<size_t>(al);
+    return track(std::aligned_alloc(a, (n + a - 1) / a * a));
+}
+
+void operator delete(void* p) noexcept { untrack(p); }
+void operator delete(void* p, size_t) noexcept { untrack(p); }
+void operator delete(void* p, std::align_val_t) noexcept { untrack(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { untrack(p); }
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,      \
+                         __LINE__, #cond);                                  \
+            ++failures;                                                     \
+        }                                                                   \
+    } while (0)
+
+constexpr size_t MAX_CAPACITY = size_t{1} << 20;
+constexpr size_t RING_BYTES = MAX_CAPACITY * sizeof(uint64_t);
+
+// Grow from 16 slots to 2^20 in one burst, then drain: only the last ring
+// may stay allocated, the ~8 MB of smaller rings before it must be gone.
+void drained_rings_are_freed() {
+    lockfree::GrowableRingBuffer<uint64_t> ring(16, MAX_CAPACITY);
+    const int64_t before = live_bytes.load();
+
+    for (uint64_t i = 0; i < MAX_CAPACITY + MAX_CAPACITY / 2; ++i) {
+        CHECK(ring.try_write(i));
+    }
+    CHECK(ring.capacity() == MAX_CAPACITY);
+    CHECK(live_bytes.load() - before > int64_t(RING_BYTES + RING_BYTES / 2));
+
+    uint64_t v;
+    uint64_t expected = 0;
+    while (ring.try_read(v)) {
+        CHECK(v == expected);
+        ++expected;
+    }
+    CHECK(expected == MAX_CAPACITY + MAX_CAPACITY / 2);
+
+    const int64_t retained = live_bytes.load() - before;
+    std::printf("retained after drain: %lld bytes\n", static_cast<long long>(retained));
+    CHECK(retained < int64_t(RING_BYTES + RING_BYTES / 4));
+}
+
+// A size() walk on another thread pins the rings it may be reading; they
+// are freed by a later advance once the walk is over.
+void concurrent_size_walks() {
+    lockfree::GrowableRingBuffer<uint64_t> ring(16, MAX_CAPACITY);
+    const int64_t before = live_bytes.load();
+    std::atomic<bool> done{false};
+
+    std::thread observer([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+            (void)ring.size();
+        }
+    });
+
+    uint64_t v;
+    for (int round = 0; round < 4; ++round) {
+        for (uint64_t i = 0; i < MAX_CAPACITY; ++i) {
+            ring.try_write(i);
+        }
+        while (ring.try_read(v)) {
+        }
+    }
+    done.store(true, std::memory_order_release);
+    observer.join();
+
+    // One more grow-and-drain with no reader around collects the leftovers
+    lockfree::GrowableRingBuffer<uint64_t> probe(16, 64);
+    for (uint64_t i = 0; i < 64; ++i) {
+        probe.try_write(i);
+    }
+    while (probe.try_read(v)) {
+    }
+
+    const int64_t retained = live_bytes.load() - before;
+    std::printf("retained after concurrent drain: %lld bytes\n", static_cast<long long>(retained));
+    CHECK(retained < int64_t(RING_BYTES + RING_BYTES / 4));
+}
+
+} // namespace
+
+int main() {
+    drained_rings_are_freed();
+    concurrent_size_walks();
+
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("growable reclaim: ok\n");
+    return 0;
+}
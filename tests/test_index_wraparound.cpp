@@ -0,0 +1,209 @@
+// Position wraparound for narrow Index types. With uint16_t positions the
+// queues wrap every 65536 operations, so the runs below wrap hundreds of
+// times, the same paths a uint32_t index takes after 2^32 operations.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "lockfree/mpmc_queue.hpp"
+#include "lockfree/spsc_ring_buffer.hpp"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,      \
+                         __LINE__, #cond);                                  \
+            ++failures;                                                     \
+        }                                                                   \
+    } while (0)
+
+constexpr uint64_t WRAPS = 500;
+constexpr uint64_t OPS = WRAPS * 65536;
+
+// Fill to capacity and drain, over and over, so every wrap happens with
+// the queue in every fill state; size() and distance() must stay exact.
+void mpmc_single_thread() {
+    lockfree::MPMCQueue<uint32_t, uint16_t> q(64);
+    uint32_t next_in = 0;
+    uint32_t next_out = 0;
+    while (next_out < OPS) {
+        while (q.try_enqueue(next_in)) {
+            ++next_in;
+        }
+        CHECK(q.size() == q.capacity());
+        uint32_t v;
+        while (q.try_dequeue(v)) {
+            CHECK(v == next_out);
+            ++next_out;
+        }
+        CHECK(q.empty());
+    }
+    CHECK(next_in == next_out);
+}
+
+// Producers tag values with their id; each consumer checks that values of
+// one producer arrive in order and the total adds up.
+void mpmc_multi_thread() {
+    constexpr unsigned PRODUCERS = 2;
+    constexpr unsigned CONSUMERS = 2;
+    constexpr uint32_t PER_PRODUCER = 4 * 65536;
+
+    lockfree::MPMCQueue<uint64_t, uint16_t> q(256);
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint32_t> received{0};
+    std::atomic<bool> ordered{true};
+
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < PRODUCERS; ++p) {
+        threads.emplace_back([&q, p] {
+            for (uint32_t i = 0; i < PER_PRODUCER; ++i) {
+                while (!q.try_enqueue((uint64_t(p) << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (unsigned c = 0; c < CONSUMERS; ++c) {
+        threads.emplace_back([&] {
+            std::vector<int64_t> last(PRODUCERS, -1);
+            while (received.load(std::memory_order_relaxed) < PRODUCERS * PER_PRODUCER) {
+                uint64_t v;
+                if (!q.try_dequeue(v)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                uint32_t p = uint32_t(v >> 32);
+                int64_t i = int64_t(uint32_t(v));
+                if (i <= last[p]) {
+                    ordered = false;
+                }
+                last[p] = i;
+                sum.fetch_add(uint32_t(v), std::memory_order_relaxed);
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    uint64_t expected = uint64_t(PRODUCERS) * (uint64_t(PER_PRODUCER) * (PER_PRODUCER - 1) / 2);
+    CHECK(ordered.load());
+    CHECK(sum.load() == expected);
+    CHECK(q.empty());
+}
+
+// Same fill/drain pattern for the SPSC ring, plus partial fills so the
+// read position crosses the wrap while the ring is not full.
+void ring_single_thread() {
+    Lockfree::RingBuffer<uint32_t, uint16_t> ring(64);
+    uint32_t next_in = 0;
+    uint32_t next_out = 0;
+    for (uint64_t round = 0; next_out < OPS; ++round) {
+        size_t batch = 1 + round % ring.capacity();
+        for (size_t i = 0; i < batch && ring.try_write(next_in); ++i) {
+            ++next_in;
+        }
+        CHECK(ring.size() == next_in - next_out);
+        CHECK(ring.available() == ring.capacity() - ring.size());
+        uint32_t v;
+        while (ring.try_read(v)) {
+            CHECK(v == next_out);
+            ++next_out;
+        }
+        CHECK(ring.empty());
+    }
+}
+
+void ring_two_threads() {
+    constexpr uint32_t N = 16 * 65536;
+    Lockfree::RingBuffer<uint32_t, uint16_t> ring(128);
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < N; ++i) {
+            while (!ring.try_write(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    bool ordered = true;
+    for (uint32_t expected = 0; expected < N;) {
+        uint32_t v;
+        if (ring.try_read(v)) {
+            ordered = ordered && v == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(ordered);
+}
+
+// Capacity must stay below half the Index range: at exactly half, a stale
+// position is a full range-half away and its distance reads as negative
+void capacity_limits() {
+    bool threw = false;
+    try {
+        lockfree::MPMCQueue<uint8_t, uint8_t> q(256);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    threw = false;
+    try {
+        lockfree::MPMCQueue<uint8_t, uint8_t> half(128);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    lockfree::MPMCQueue<uint8_t, uint8_t> largest(64);
+    CHECK(largest.capacity() == 64);
+    for (int round = 0; round < 10; ++round) {
+        size_t n = 0;
+        while (largest.try_enqueue(uint8_t(n))) {
+            ++n;
+        }
+        CHECK(n == 64);
+        uint8_t v;
+        while (largest.try_dequeue(v)) {
+        }
+    }
+
+    threw = false;
+    try {
+        Lockfree::RingBuffer<uint8_t, uint8_t> ring(128);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    Lockfree::RingBuffer<uint8_t, uint8_t> ring(64);
+    CHECK(ring.capacity() == 64);
+}
+
+} // namespace
+
+int main() {
+    mpmc_single_thread();
+    mpmc_multi_thread();
+    ring_single_thread();
+    ring_two_threads();
+    capacity_limits();
+
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("index wraparound: ok\n");
+    return 0;
+}